@@ -28,12 +28,22 @@
 
 #include "DetectorConstruction.hh"
 #include "ActionInitialization.hh"
+#include "PhysicsList.hh"
+#include "PhysicsTableCache.hh"
+#include "ScanEngine.hh"
+#include "EventSeeder.hh"
+#include "WorkerInitialization.hh"
 
 #include "G4RunManagerFactory.hh"
+#ifdef G4MULTITHREADED
+#include "G4MTRunManager.hh"
+#include "AdaptiveRunManager.hh"
+#endif
 
 #include "G4UImanager.hh"
 #include "G4UIcommand.hh"
 #include "FTFP_BERT.hh"
+#include "G4StepLimiterPhysics.hh"
 
 //#include "G4ScoringManager.hh"
 
@@ -47,9 +57,16 @@
 namespace {
   void PrintUsage() {
     G4cerr << " Usage: " << G4endl;
-    G4cerr << " exampleB4c [-m macro ] [-u UIsession] [-t nThreads]" << G4endl;
-    G4cerr << "   note: -t option is available only for multi-threaded mode."
+    G4cerr << " exampleB4c [-m macro ] [-u UIsession] [-t nThreads] [-p physicsList]"
+           << " [-r runManager] [-a pinning] [-b batching]" << G4endl;
+    G4cerr << "   note: -t, -r, -a and -b options are available only for multi-threaded mode."
            << G4endl;
+    G4cerr << "   nThreads: number of workers, 0 (default) for the cores available" << G4endl;
+    G4cerr << "   runManager: default, tasking, mt or serial" << G4endl;
+    G4cerr << "   pinning: none (default), core or numa" << G4endl;
+    G4cerr << "   batching: fixed (default) or adaptive event chunks (MT run manager)" << G4endl;
+    G4cerr << "   physicsList: FTFP_BERT (default), or EM only: emstandard,"
+           << " emstandard_opt3, emstandard_opt4, emlivermore" << G4endl;
   }
 }
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -58,23 +75,54 @@ int main(int argc,char** argv)
 {
   // Evaluate arguments
   //
-  if ( argc > 7 ) {
+  if ( argc > 15 ) {
     PrintUsage();
     return 1;
   }
   
   G4String macro;
   G4String session;
+  G4String physicsListName = "FTFP_BERT";
+  auto runManagerType = G4RunManagerType::Default;
 #ifdef G4MULTITHREADED
-  G4int nThreads = 16;
+  G4int nThreads = 0;
+  auto pinning = WorkerInitialization::kNoPinning;
+  G4bool adaptiveBatching = false;
 #endif
   for ( G4int i=1; i<argc; i=i+2 ) {
     if      ( G4String(argv[i]) == "-m" ) macro = argv[i+1];
     else if ( G4String(argv[i]) == "-u" ) session = argv[i+1];
+    else if ( G4String(argv[i]) == "-p" ) physicsListName = argv[i+1];
 #ifdef G4MULTITHREADED
     else if ( G4String(argv[i]) == "-t" ) {
       nThreads = G4UIcommand::ConvertToInt(argv[i+1]);
     }
+    else if ( G4String(argv[i]) == "-r" ) {
+      G4String type = argv[i+1];
+      if      ( type == "default" ) runManagerType = G4RunManagerType::Default;
+      else if ( type == "tasking" ) runManagerType = G4RunManagerType::Tasking;
+      else if ( type == "mt" )      runManagerType = G4RunManagerType::MT;
+      else if ( type == "serial" )  runManagerType = G4RunManagerType::Serial;
+      else {
+        PrintUsage();
+        return 1;
+      }
+    }
+    else if ( G4String(argv[i]) == "-a" ) {
+      if ( ! WorkerInitialization::ParsePinning(argv[i+1], pinning) ) {
+        PrintUsage();
+        return 1;
+      }
+    }
+    else if ( G4String(argv[i]) == "-b" ) {
+      G4String batching = argv[i+1];
+      if      ( batching == "fixed" )    adaptiveBatching = false;
+      else if ( batching == "adaptive" ) adaptiveBatching = true;
+      else {
+        PrintUsage();
+        return 1;
+      }
+    }
 #endif
     else {
       PrintUsage();
@@ -93,14 +141,27 @@ int main(int argc,char** argv)
   //
   // G4Random::setTheEngine(new CLHEP::MTwistEngine);
   
-  // Construct the default run manager
+  // Construct the run manager (the default one can be changed with the
+  // G4RUN_MANAGER_TYPE environment variable)
   //
-  auto* runManager =
-    G4RunManagerFactory::CreateRunManager(G4RunManagerType::Default);
+  G4RunManager* runManager = nullptr;
 #ifdef G4MULTITHREADED
-  if ( nThreads > 0 ) { 
-    runManager->SetNumberOfThreads(nThreads);
-  }  
+  // Adaptive event chunks (/btf/run/): an MT run manager whatever -r
+  if ( adaptiveBatching ) runManager = new AdaptiveRunManager();
+#endif
+  if ( ! runManager ) {
+    runManager = G4RunManagerFactory::CreateRunManager(runManagerType);
+  }
+#ifdef G4MULTITHREADED
+  // One worker per core available to the process, unless given
+  if ( nThreads <= 0 ) nThreads = WorkerInitialization::AvailableCores();
+  runManager->SetNumberOfThreads(nThreads);
+  // the tasking run manager is an MT run manager; a sequential one (from
+  // G4RUN_MANAGER_TYPE) has no workers to pin
+  if ( pinning != WorkerInitialization::kNoPinning &&
+       dynamic_cast<G4MTRunManager*>(runManager) ) {
+    runManager->SetUserInitialization(new WorkerInitialization(pinning));
+  }
 #endif
 
   // Set mandatory initialization classes
@@ -108,8 +169,30 @@ int main(int argc,char** argv)
   auto detConstruction = new DetectorConstruction();
   runManager->SetUserInitialization(detConstruction);
 
-  auto physicsList = new FTFP_BERT;
+  G4VModularPhysicsList* physicsList = nullptr;
+  if ( physicsListName == "FTFP_BERT" ) {
+    physicsList = new FTFP_BERT;
+  }
+  else if ( PhysicsList::IsEmPhysicsName(physicsListName) ) {
+    physicsList = new PhysicsList(physicsListName);
+  }
+  else {
+    PrintUsage();
+    return 1;
+  }
+  // Step limit and kinetic energy threshold of the regions (/btf/det/)
+  physicsList->RegisterPhysics(new G4StepLimiterPhysics());
+  // The fast simulation of the air gaps is registered by /btf/det/setFastAir
   runManager->SetUserInitialization(physicsList);
+
+  // Physics tables kept on disk with /btf/phys/tableCache
+  auto tableCache = new PhysicsTableCache(physicsList);
+
+  // Parameter scans in this process with /btf/scan/run
+  auto scanEngine = new ScanEngine();
+
+  // Per-event seeds, /btf/random/runSeed and /btf/random/replayEvents
+  auto eventSeeder = new EventSeeder();
     
   //auto actionInitialization = new ActionInitialization(detConstruction);
   //runManager->SetUserInitialization(actionInitialization);
@@ -150,8 +233,12 @@ int main(int argc,char** argv)
   // owned and deleted by the run manager, so they should not be deleted 
   // in the main() program !
 
+  // the cache refers to the physics list, deleted with the run manager
+  delete tableCache;
   delete visManager;
   delete runManager;
+  delete scanEngine;
+  delete eventSeeder;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,83 @@
+#!/bin/bash
+#
+# Throughput benchmark of TestEm4 on canonical scenarios, with fixed seeds,
+# at several thread counts. Writes benchmark.csv (scenario, threads, events,
+# initialization time, events/s, peak RSS) and, given a previous report,
+# flags the throughput regressions.
+#
+# Usage: ./benchmark.sh [baseline.csv] [tolerance %]
+#   run from the build directory (or make benchmark); the thread counts are
+#   taken from BENCH_THREADS, the number of bunches per scenario is scaled
+#   by BENCH_SCALE. Exits with 1 if a scenario is slower than the baseline
+#   by more than the tolerance (5% by default).
+#
+baseline=$1
+tolerance=${2:-5}
+threadCounts=${BENCH_THREADS:-"1 4 16"}
+scale=${BENCH_SCALE:-1}
+report=benchmark.csv
+
+# Scenarios: 450 MeV electrons from the beam pipe exit window, or the
+# particles reaching the DUT box, recorded by fitpixOnly (window and Fitpix,
+# killed on the phase-space plane) and replayed by dutOnly
+scenarios="single mult10 mult1000 fitpixOnly dutOnly"
+
+runScenario() {
+  local name=$1 bunches multiplicity=1 preInit="" source=""
+  case $name in
+    single)     bunches=20000 ;;
+    mult10)     bunches=2000;  multiplicity=10 ;;
+    mult1000)   bunches=20;    multiplicity=1000 ;;
+    fitpixOnly) bunches=20000; rm -f benchmark_phsp.bin*
+                preInit="/btf/det/recordPhaseSpace benchmark_phsp.bin" ;;
+    dutOnly)    bunches=20000; source="/btf/gun/replayPhaseSpace benchmark_phsp.bin" ;;
+  esac
+  local events=$((bunches*scale))
+  {
+    echo "/control/verbose 1"
+    echo "/run/verbose 1"
+    echo "/random/setSeeds 12345 67890"
+    echo "$preInit"
+    echo "/run/initialize"
+    echo "/gps/particle e-"
+    echo "/gps/energy 450 MeV"
+    echo "/gps/position 0 0 60 cm"
+    echo "/gps/direction 0 0 -1"
+    echo "$source"
+    echo "/btf/gun/setMultiplicity $multiplicity"
+    echo "/run/beamOn $events"
+  } > benchmark_point.mac
+  local log=benchmark_${name}_t$threads.log
+  ./TestEm4 -t $threads -m benchmark_point.mac > $log 2>&1 || {
+    echo "TestEm4 failed, see $log"
+    exit 1
+  }
+  local init=$(grep -- "---> Initialization time:" $log | awk '{print $4}')
+  local rate=$(grep -- "---> Run 0:" $log | tail -1 | awk '{print $9}')
+  local rss=$(grep -- "---> Peak RSS:" $log | tail -1 | awk '{print $4}')
+  echo "$name,$threads,$events,$init,$rate,$rss" >> $report
+  printf "%-12s %8s %10s %10s %12s %10s\n" $name $threads $events "$init" "$rate" "$rss"
+}
+
+echo "scenario,threads,events,init_s,events_per_s,peak_rss_mb" > $report
+printf "%-12s %8s %10s %10s %12s %10s\n" "scenario" "threads" "events" "init [s]" "events/s" "RSS [MB]"
+for threads in $threadCounts; do
+  for scenario in $scenarios; do
+    runScenario $scenario
+  done
+done
+rm -f benchmark_point.mac benchmark_phsp.bin* dutOut.root
+
+# Regression report against a previous benchmark.csv
+[ -z "$baseline" ] && exit 0
+echo
+echo "=== regressions vs $baseline (tolerance $tolerance%)"
+awk -F, -v tol=$tolerance '
+  NR == FNR { if ( FNR > 1 ) ref[$1","$2] = $5; next }
+  FNR > 1 && ($1","$2) in ref && ref[$1","$2] > 0 {
+    change = 100*($5 - ref[$1","$2])/ref[$1","$2]
+    flag = change < -tol ? "REGRESSION" : ""
+    if ( flag != "" ) failed = 1
+    printf "%-12s %8s %12.4g -> %12.4g %+8.1f%% %s\n", $1, $2, ref[$1","$2], $5, change, flag
+  }
+  END { exit failed }' $baseline $report
@@ -0,0 +1,54 @@
+#!/bin/bash
+#
+# Scan the production cuts of the sensor and passive regions: for each pair
+# of cuts, run a short batch and measure the events/s and the shift of the
+# energy deposit histograms relative to the reference cuts. cuttune.C then
+# reports the fastest pair whose shifts are all within the tolerance.
+#
+# Usage: ./cuttune.sh [nThreads] [nEvents] [tolerance %]
+#   run from the build directory; the grid (in mm) is taken from
+#   SENSOR_CUTS and PASSIVE_CUTS, the reference from REF_SENSOR_CUT and
+#   REF_PASSIVE_CUT. Each point writes cuttune_<sensor>_<passive>.root/.log
+#
+threads=${1:-16}
+events=${2:-20000}
+tolerance=${3:-1}
+sensorCuts=${SENSOR_CUTS:-"0.01 0.1 0.7"}
+passiveCuts=${PASSIVE_CUTS:-"0.7 2 10 100"}
+refSensor=${REF_SENSOR_CUT:-0.7}
+refPassive=${REF_PASSIVE_CUT:-0.7}
+
+runPoint() {
+  local tag=${1}_${2}
+  cat > cuttune_point.mac <<END
+/control/alias sensorCut $1
+/control/alias passiveCut $2
+/control/alias nEvents $events
+/control/execute cuttune.mac
+END
+  ./TestEm4 -t $threads -m cuttune_point.mac > cuttune_$tag.log 2>&1 || {
+    echo "TestEm4 failed, see cuttune_$tag.log"
+    exit 1
+  }
+  mv dutOut.root cuttune_$tag.root
+  rate=$(grep -- "---> Run 0:" cuttune_$tag.log | tail -1 | awk '{print $9}')
+  echo "$tag $rate" >> cuttune_rates.txt
+  printf "%-16s %12s events/s\n" $tag "$rate"
+}
+
+rm -f cuttune_rates.txt
+echo "=== reference"
+runPoint $refSensor $refPassive
+tags=""
+echo "=== scan"
+for sensor in $sensorCuts; do
+  for passive in $passiveCuts; do
+    [ "$sensor" == "$refSensor" ] && [ "$passive" == "$refPassive" ] && continue
+    runPoint $sensor $passive
+    tags="$tags ${sensor}_${passive}"
+  done
+done
+rm -f cuttune_point.mac
+
+echo
+root -l -b -q "cuttune.C(\"${refSensor}_${refPassive}\", \"$tags\", $tolerance)"
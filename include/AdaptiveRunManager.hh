@@ -0,0 +1,65 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file AdaptiveRunManager.hh
+/// \brief Definition of the AdaptiveRunManager class
+
+#ifndef AdaptiveRunManager_h
+#define AdaptiveRunManager_h 1
+
+#include "ChunkScheduler.hh"
+
+#include "G4MTRunManager.hh"
+#include "globals.hh"
+
+/// MT run manager dealing the events in adaptive chunks (TestEm4 -b adaptive)
+///
+/// G4MTRunManager gives each worker eventModulo events at a time, fixed for
+/// the run. Here the worker asking for events gets a chunk sized by the
+/// ChunkScheduler from the measured event cost, and G4MTRunManager then
+/// assigns the event IDs and the seeds of the chunk as usual: the seeds
+/// still follow the event IDs, so the results do not depend on the chunking.
+/// A /run/eventModulo set explicitly gives the fixed chunks back.
+
+class AdaptiveRunManager : public G4MTRunManager
+{
+  public:
+    AdaptiveRunManager();
+    virtual ~AdaptiveRunManager();
+
+    virtual void InitializeEventLoop(G4int nofEvents, const char* macroFile = nullptr,
+                                     G4int nofSelect = -1);
+    virtual G4int SetUpNEvents(G4Event* event, G4SeedsQueue* seedsQueue,
+                               G4bool reseedRequired = true);
+    virtual void RunTermination();
+
+  private:
+    ChunkScheduler fScheduler;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
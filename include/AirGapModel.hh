@@ -0,0 +1,73 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file AirGapModel.hh
+/// \brief Definition of the AirGapModel class
+
+#ifndef AirGapModel_h
+#define AirGapModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "G4EmCalculator.hh"
+
+class G4Region;
+class G4Track;
+class G4Material;
+
+/// Parametrised transport of e+/e- through the air gaps
+///
+/// Attached to the region of the two air envelopes between the exit window,
+/// the Fitpix and the DUT box (/btf/det/setFastAir). A track above the
+/// energy threshold that would leave the envelope through its upstream or
+/// downstream face is moved there in one step: mean energy loss from the
+/// restricted dE/dx tables, gaussian (Highland) multiple scattering angle
+/// and correlated lateral displacement. No secondaries are produced, so the
+/// rare hard bremsstrahlung photons of the air are missing; the full
+/// transport is recovered with /param/inActivateModel AirGapModel.
+
+class AirGapModel : public G4VFastSimulationModel
+{
+  public:
+    AirGapModel(const G4String& name, G4Region* envelope, G4double minEkin);
+    virtual ~AirGapModel();
+
+    // methods from base class
+    virtual G4bool IsApplicable(const G4ParticleDefinition& particle);
+    virtual G4bool ModelTrigger(const G4FastTrack& fastTrack);
+    virtual void   DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep);
+
+  private:
+    G4double HighlandAngle(const G4Track* track, G4double length, const G4Material* material) const;
+
+    G4Region*      fEnvelope;
+    G4double       fMinEkin;  // full transport below this kinetic energy
+    G4EmCalculator fEmCalculator;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
+
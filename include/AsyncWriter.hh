@@ -0,0 +1,98 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file AsyncWriter.hh
+/// \brief Definition of the AsyncWriter class
+
+#ifndef AsyncWriter_h
+#define AsyncWriter_h 1
+
+#include "EventRecord.hh"
+#include "OverlayEngine.hh"
+#include "SpscQueue.hh"
+#include "G4Threading.hh"
+#include "globals.hh"
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/// Event output written by a dedicated thread
+///
+/// When started (/btf/output/asyncFile), the event action of each worker
+/// converts its event record to compact rows (the overlay library format,
+/// see OverlayRecord) and pushes them to its own lock-free queue instead of
+/// filling the ntuples. A writer thread drains the queues and writes the
+/// rows to a single file in large batches, so that the writing overlaps with
+/// the transport. The file can be read back with ReadBinaryShards() or used
+/// directly as an overlay library.
+///
+/// There is one instance, started and stopped by the master run action
+/// around each run. The file is created by the first run writing to it and
+/// stays open: the next runs of the job append their events.
+
+class AsyncWriter
+{
+  public:
+    static AsyncWriter* Instance();
+
+    void Start(const G4String& fileName);
+    void Stop();
+
+    G4bool IsActive() const { return fActive.load(std::memory_order_acquire); }
+
+    // Worker side: queue the record of one event
+    void Push(const EventRecord& record);
+
+  private:
+    AsyncWriter();
+    ~AsyncWriter();
+
+    using Rows = std::vector<OverlayRecord>;
+    using Queue = SpscQueue<Rows>;
+
+    Queue* GetThreadQueue();
+    void Run();
+    void Flush();
+
+    std::atomic<G4bool>                 fActive;
+    std::atomic<G4bool>                 fStopping;
+    std::thread                         fThread;
+    std::ofstream                       fFile;
+    G4String                            fFileName;
+    std::vector<OverlayRecord>          fBatch;
+    // one queue per producing thread, kept for the whole job
+    G4Mutex                             fQueuesMutex;
+    std::vector<std::unique_ptr<Queue>> fQueues;
+    std::atomic<std::size_t>            fNofQueues;
+    std::size_t                         fNofEvents;
+    std::atomic<std::size_t>            fNofFullQueues;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,131 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file BinaryIO.hh
+/// \brief Helpers shared by the binary side files written by the workers
+
+#ifndef BinaryIO_h
+#define BinaryIO_h 1
+
+#include "G4Threading.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+/// Binary side files are a fixed header followed by fixed-size records.
+/// In MT mode each worker writes its own shard "<base>.t<threadID>";
+/// ReadBinaryShards() concatenates "<base>" and all its shards.
+
+struct BinaryFileHeader
+{
+  char          magic[8];   ///< file type, zero padded
+  std::uint32_t version;    ///< record layout version
+  std::uint32_t recordSize; ///< sizeof(record) when written
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4String ThreadFileName(const G4String& base)
+{
+  auto threadID = G4Threading::G4GetThreadId();
+  if ( threadID < 0 ) return base;   // sequential or master
+  std::ostringstream name;
+  name << base << ".t" << threadID;
+  return name.str();
+}
+
+inline void WriteBinaryHeader(std::ostream& out, const char* magic,
+                              std::uint32_t version, std::uint32_t recordSize)
+{
+  BinaryFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::strncpy(header.magic, magic, sizeof(header.magic));
+  header.version = version;
+  header.recordSize = recordSize;
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Append the records of one file to records. Returns false if the file
+/// cannot be opened; a file of the wrong type is a fatal error.
+template <typename Record>
+G4bool ReadBinaryFile(const G4String& fileName, const char* magic,
+                      std::uint32_t version, std::vector<Record>& records)
+{
+  std::ifstream in(fileName, std::ios::binary);
+  if ( ! in ) return false;
+
+  BinaryFileHeader header;
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if ( ! in || std::strncmp(header.magic, magic, sizeof(header.magic)) != 0
+       || header.version != version || header.recordSize != sizeof(Record) ) {
+    G4ExceptionDescription msg;
+    msg << "File " << fileName << " is not a " << magic
+        << " v" << version << " file.";
+    G4Exception("ReadBinaryFile()", "MyCode0010", FatalException, msg);
+    return false;
+  }
+
+  in.seekg(0, std::ios::end);
+  auto nofRecords = (std::size_t(in.tellg()) - sizeof(header)) / sizeof(Record);
+  in.seekg(sizeof(header), std::ios::beg);
+  auto offset = records.size();
+  records.resize(offset + nofRecords);
+  in.read(reinterpret_cast<char*>(records.data() + offset), nofRecords*sizeof(Record));
+  return true;
+}
+
+/// Read "<base>" (sequential output) or "<base>.t0", "<base>.t1", ...
+/// (MT output) into a single record list. Returns the number of files read.
+/// Both kinds together come from two different runs: a fatal error.
+template <typename Record>
+G4int ReadBinaryShards(const G4String& base, const char* magic,
+                       std::uint32_t version, std::vector<Record>& records)
+{
+  G4bool sequential = ReadBinaryFile(base, magic, version, records);
+  G4int nofFiles = sequential ? 1 : 0;
+  for ( G4int i = 0; ; ++i ) {
+    std::ostringstream name;
+    name << base << ".t" << i;
+    if ( ! ReadBinaryFile(name.str(), magic, version, records) ) break;
+    ++nofFiles;
+  }
+  if ( sequential && nofFiles > 1 ) {
+    G4ExceptionDescription msg;
+    msg << "Both " << base << " (sequential run) and " << base
+        << ".t* (MT run) exist: remove the stale one(s).";
+    G4Exception("ReadBinaryShards()", "MyCode0010", FatalException, msg);
+  }
+  return nofFiles;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,75 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file BunchAssembler.hh
+/// \brief Definition of the BunchAssembler class
+
+#ifndef BunchAssembler_h
+#define BunchAssembler_h 1
+
+#include "EventRecord.hh"
+#include "G4Threading.hh"
+#include "globals.hh"
+
+#include <map>
+
+/// Merges the event records of the sub-events of a bunch
+///
+/// The sub-events of one bunch are processed by any of the worker threads.
+/// Each one adds its record here; the thread adding the last one gets the
+/// record of the whole bunch and fills the output with it. There is one
+/// instance shared by all the threads, reset by the master at the start of
+/// each run.
+
+class BunchAssembler
+{
+  public:
+    static BunchAssembler* Instance();
+
+    // Add the record of a sub-event. Return true when the bunch is complete,
+    // the record then holds the whole bunch.
+    G4bool Add(EventRecord& record, G4int subEvent, G4int nofSubEvents);
+
+    void Reset();
+    // Drop the bunches still incomplete (run not a whole number of bunches)
+    // and return their number
+    G4int DropIncomplete();
+
+  private:
+    BunchAssembler() {}
+
+    struct Pending {
+      EventRecord fRecord;
+      G4int       fNofAdded = 0;
+      G4double    fPrimaryEnergy = 0.;   ///< energy of the first primary of sub-event 0
+    };
+
+    G4Mutex fMutex;
+    std::map<G4int, Pending> fPending;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,93 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ChannelIndex.hh
+/// \brief Definition of the ChannelIndex class
+
+#ifndef ChannelIndex_h
+#define ChannelIndex_h 1
+
+#include "globals.hh"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+class G4ParticleDefinition;
+class G4VProcess;
+
+/// Dense IDs for the (particle, process) pairs met by one thread
+///
+/// The ID is given the first time a pair is seen, so that per-thread
+/// counts can be kept in flat tables indexed by it. Consecutive lookups
+/// mostly share the pair (steps of one track, secondaries of one kind) and
+/// are answered from the last one without searching the map.
+
+class ChannelIndex
+{
+  public:
+    struct Channel {
+      const G4ParticleDefinition* fParticle;
+      const G4VProcess*           fProcess;
+    };
+
+    G4int ID(const G4ParticleDefinition* particle, const G4VProcess* process);
+
+    std::size_t    Size() const                 { return fChannels.size(); }
+    const Channel& operator[](std::size_t id) const { return fChannels[id]; }
+
+  private:
+    std::vector<Channel> fChannels;
+    std::map<std::pair<const G4ParticleDefinition*, const G4VProcess*>, G4int> fIDs;
+    Channel fLast = {nullptr, nullptr};
+    G4int   fLastID = -1;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4int ChannelIndex::ID(const G4ParticleDefinition* particle, const G4VProcess* process)
+{
+  if ( fLastID >= 0 && particle == fLast.fParticle && process == fLast.fProcess ) return fLastID;
+
+  auto key = std::make_pair(particle, process);
+  auto it = fIDs.find(key);
+  G4int id;
+  if ( it != fIDs.end() ) {
+    id = it->second;
+  }
+  else {
+    id = G4int(fChannels.size());
+    fChannels.push_back({particle, process});
+    fIDs[key] = id;
+  }
+  fLast = {particle, process};
+  fLastID = id;
+  return id;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
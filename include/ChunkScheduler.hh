@@ -0,0 +1,86 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ChunkScheduler.hh
+/// \brief Definition of the ChunkScheduler class
+
+#ifndef ChunkScheduler_h
+#define ChunkScheduler_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+#include <vector>
+
+class SchedulerMessenger;
+
+/// Size of the chunks of events dealt to the workers (AdaptiveRunManager)
+///
+/// The cost of an event is measured on the master from the time a worker
+/// takes to come back for a new chunk, divided by the size of its previous
+/// chunk, and smoothed over the workers. Each chunk is sized to last about
+/// the chunk time (/btf/run/chunkTime), but never more than half of the
+/// remaining events shared among the workers, so that the chunks shrink to
+/// one event at the end of the run and the workers finish together.
+/// The first chunk of each worker, before any measurement, is one event.
+/// NextChunk() is called by the workers under the lock of the run manager.
+
+class ChunkScheduler
+{
+  public:
+    ChunkScheduler();
+   ~ChunkScheduler();
+
+    void SetChunkTime(G4double value) { fChunkTime = value; }
+    void SetMaxChunk(G4int value)     { fMaxChunk = value; }
+
+    // Master: forget the measurements at the start of a run
+    void Reset();
+    // Size of the next chunk of the calling worker
+    G4int NextChunk(G4int threadID, G4int nofRemaining, G4int nofWorkers);
+    // Master: chunks dealt in the run
+    void Print() const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    struct Worker {
+      Clock::time_point fStart;
+      G4int             fChunk = 0;
+    };
+
+    SchedulerMessenger* fMessenger;
+    G4double fChunkTime;    // target duration of a chunk (G4 time units)
+    G4int    fMaxChunk;
+    G4double fEventCost;    // smoothed wall time per event (G4 time units)
+    std::vector<Worker> fWorkers;
+    G4int    fNofChunks;
+    G4int    fNofEvents;
+    G4int    fLargestChunk;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
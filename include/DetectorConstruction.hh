@@ -31,10 +31,14 @@
 #define DetectorConstruction_h 1
 
 #include "G4VUserDetectorConstruction.hh"
+#include "G4ThreeVector.hh"
 #include "globals.hh"
 
 class G4VPhysicalVolume;
+class G4AssemblyVolume;
+class G4LogicalVolume;
 class G4Region;
+class DetectorMessenger;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -47,20 +51,74 @@ class DetectorConstruction : public G4VUserDetectorConstruction
   public:
     virtual G4VPhysicalVolume* Construct();
     virtual void ConstructSDandField();
-    G4Region* GetTargetRegion(){ return fRegion;}
+    G4Region* GetTargetRegion(){ return fRegions[kSensorRegion];}
+
+    // Sensor region (sapphire wafers and Fitpix sensor) and passive region
+    // (box, PCBs, exit window, Fitpix asic and the air, i.e. the default
+    // region of the world) with their own production cut, maximum step and
+    // kinetic energy below which the tracks are killed (<= 0: not set).
+    // The passive cut is also the default cut of the physics list.
+    enum { kSensorRegion = 0, kPassiveRegion = 1, kNofRegions = 2 };
+    void SetRegionCut(G4int region, G4double cut);
+    void SetRegionMaxStep(G4int region, G4double maxStep);
+    void SetRegionMinEkin(G4int region, G4double minEkin);
+
+    // Single solid wafers segmented in depth by the SDs (virtual layers)
+    // instead of one placed volume per layer
+    void   SetVirtualLayers(G4bool value) { fVirtualLayers = value; }
+    G4bool GetVirtualLayers() const       { return fVirtualLayers; }
+
+    // Scoring plane in front of the DUT box writing the phase space of the
+    // particles reaching it (empty name: no plane)
+    void SetPhaseSpaceFile(const G4String& fileName) { fPhaseSpaceFile = fileName; }
+
+    // Air envelopes between the exit window, the Fitpix and the DUT box,
+    // where the e+/e- above minEkin are transported by AirGapModel. The
+    // fast simulation process is only added to the physics list then
+    void SetFastAir(G4bool value);
+    void SetFastAirMinEkin(G4double minEkin) { fFastAirMinEkin = minEkin; }
+
+    // Transverse position of the DUT box (and of the phase-space plane)
+    // relative to the nominal one, the small pad 4 on the beam axis. Once
+    // built, the placed volumes are moved and the geometry is re-optimised
+    // at the next run: no new geometry, physics or SDs. The etotLP/etotSP
+    // circles stay on the beam axis; the stacking acceptance target follows.
+    void SetDUTPosition(G4double x, G4double y);
+    const G4ThreeVector& GetDUTPosition() const { return fDUTPosition; }
 
   private:
     // methods
     //
     void DefineMaterials();
     G4VPhysicalVolume* DefineVolumes();
+    void ApplyRegionSettings(G4int region);
+    void PlacePadMetallizations(G4LogicalVolume* waferL, G4double zSurface,
+                                G4LogicalVolume* largeL, G4LogicalVolume* smallL,
+                                G4LogicalVolume* halfMoonL, const G4ThreeVector& halfMoonPos);
 
     // data members
     //
     G4int     fANbofLayers;     // number of layers detector upstream (also called A)
     G4int     fBNbofLayers;     // number of layers detector downstream (also called B)
     G4int     fFitpixNbofLayers;// number of layers fitpix detector
-    G4Region* fRegion;
+    G4double  fWaferThickness;  // thickness of the sapphire wafer upstream (A)
+    G4double  fWaferBThickness; // thickness of the sapphire wafer downstream (B)
+    G4double  fFitpixThickness; // thickness of the fitpix sensor (without asic)
+    G4bool    fVirtualLayers;   // depth segmentation done in the SDs
+    G4String  fPhaseSpaceFile;  // phase-space output of the scoring plane
+    G4bool    fFastAir;         // parametrised transport in the air gaps
+    G4bool    fFastAirPhysics;  // fast simulation registered to the physics list
+    G4double  fFastAirMinEkin;  // full transport below this kinetic energy
+    G4Region* fAirGapRegion;
+    G4ThreeVector      fDUTPosition;     // transverse offset of the DUT box
+    G4AssemblyVolume*  fDUTBox;          // DUT box with the wafers, once built
+    G4VPhysicalVolume* fPhaseSpacePlane;
+    G4Region* fRegions[kNofRegions];
+    G4double  fRegionCut[kNofRegions];
+    G4double  fRegionMaxStep[kNofRegions];
+    G4double  fRegionMinEkin[kNofRegions];
+
+    DetectorMessenger* fDetectorMessenger;
 
     G4LogicalVolume* sapphireWaferLayerL;
 };
@@ -38,22 +38,29 @@
 
 #include "G4UserEventAction.hh"
 
-#include "DUTHit.hh"
+#include "EventRecord.hh"
 
 #include "globals.hh"
 
+class OverlayEngine;
+class RunAction;
+class HitStore;
+
 /// Event action class
 ///
 /// In EndOfEventAction(), it prints the accumulated quantities of the energy 
 /// deposit and layer number of particles in the DUT layers 
-/// stored in the hits collections.
+/// stored in the hit stores of the sensitive detectors.
+///
+/// The hits are first summarised in an EventRecord, which is then used to
+/// fill the histograms and ntuples.
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class EventAction : public G4UserEventAction
 {
   public:
-    EventAction();
+    EventAction(RunAction* runAction, OverlayEngine* overlay = nullptr);
     virtual ~EventAction();
 
     virtual void BeginOfEventAction(const G4Event* event);
@@ -64,14 +71,22 @@ class EventAction : public G4UserEventAction
         
   private:
     // methods
-    DUTHitsCollection* GetHitsCollection(G4int hcID,
-                                              const G4Event* event) const;
+    const HitStore& GetHitStore(const G4String& sdName) const;
     void PrintEventStatistics(G4double dutEdep, G4double dutTrackLength) const;
+    void FillOutputs(const EventRecord& record) const;
+    void FillDUTOutputs(const SensorRecord& dut, G4int eventID,
+                        G4int firstH1, G4int h2, G4int waferID,
+                        G4bool fillNtuples) const;
+    void FillDUTEventRow(const EventRecord& record) const;
     
     // data members                   
-    G4int  fdutAHCID;
-    G4int  fdutBHCID;
-    G4int  ffitpixHCID;
+    RunAction*     fRunAction;
+    OverlayEngine* fOverlay;
+    EventRecord fRecord;
+    //
+    const HitStore* fDutAStore;
+    const HitStore* fDutBStore;
+    const HitStore* fFitpixStore;
     //
     G4double fTotalEnergyDeposit;
     G4double fTotalEnergyDeposit_dutB;
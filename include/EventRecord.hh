@@ -0,0 +1,114 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EventRecord.hh
+/// \brief Definition of the EventRecord class
+
+#ifndef EventRecord_h
+#define EventRecord_h 1
+
+#include "PadLayout.hh"
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <array>
+#include <vector>
+
+/// Energy deposited in one layer of a sensor. As in HitStore, fPos is the sum
+/// of the step mid-points, not their average.
+
+struct LayerDeposit
+{
+  G4int         fLayer;
+  G4double      fEdep;
+  G4ThreeVector fPos;
+};
+
+/// Content of one sensor in an event: the non-empty layers in increasing
+/// order plus the total and pad sums.
+///
+/// Records add up: the sum of the records of a set of primaries is the
+/// record of the event containing all of them.
+
+struct SensorRecord
+{
+  std::vector<LayerDeposit> fLayers;
+  G4double fEdep      = 0.;   ///< total energy deposit
+  G4double fTrackLength = 0.; ///< charged track length
+  G4double fEdepLarge = 0.;   ///< energy deposit in the large pad region
+  G4double fEdepSmall = 0.;   ///< energy deposit in the small pad region
+  G4int    fNofLayers = 0;    ///< number of layers of the sensor
+  std::array<G4double, PadLayout::kNofPads> fPadEdep {};   ///< energy deposit per pad
+
+  void Clear();
+  void Add(const SensorRecord& other);
+};
+
+/// Content of one event in the three sensors, as used to fill the output
+
+struct EventRecord
+{
+  G4int    fEventID       = -1;
+  G4double fPrimaryEnergy = 0.;   ///< energy of the first primary
+  SensorRecord fDutA;             ///< upstream sapphire sensor (110 um)
+  SensorRecord fDutB;             ///< downstream sapphire sensor (150 um)
+  SensorRecord fFitpix;           ///< Fitpix sensor
+
+  void Clear();
+  void Add(const EventRecord& other);
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void SensorRecord::Clear()
+{
+  fLayers.clear();
+  fEdep = fTrackLength = fEdepLarge = fEdepSmall = 0.;
+  fNofLayers = 0;
+  fPadEdep.fill(0.);
+}
+
+inline void EventRecord::Clear()
+{
+  fEventID = -1;
+  fPrimaryEnergy = 0.;
+  fDutA.Clear();
+  fDutB.Clear();
+  fFitpix.Clear();
+}
+
+inline void EventRecord::Add(const EventRecord& other)
+{
+  // the first primary stays the one of this record, if any
+  if ( fPrimaryEnergy == 0. ) fPrimaryEnergy = other.fPrimaryEnergy;
+  fDutA.Add(other.fDutA);
+  fDutB.Add(other.fDutB);
+  fFitpix.Add(other.fFitpix);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EventSeeder.hh
+/// \brief Definition of the EventSeeder class
+
+#ifndef EventSeeder_h
+#define EventSeeder_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class SeedMessenger;
+
+/// Per-event seeding (counter-based) and replay of single events
+///
+/// Before its primaries are generated, each event reseeds the engine of its
+/// thread from the pair (run seed, event ID) only, whatever the thread and
+/// the events it processed before, so the random numbers of an event do not
+/// depend on the number of threads or on the chunks of events. With MixMax
+/// (the default engine) the two seeds select one of the non-overlapping
+/// streams of the engine. The master fixes the run seed at the start of the
+/// run from a base seed and the run ID, and prints it. The base seed is set
+/// with /btf/random/runSeed, or drawn from the engine at the first run (so
+/// /random/setSeeds and /random/resetEngineFrom before it set the job).
+///
+/// /btf/random/replayEvents <runSeed> <eventID>... runs again the events of
+/// the list, with one event loop thread only, into <file>_replay. The engine
+/// status saved for each event by /random/setSavingFlag is taken before the
+/// reseed: /random/resetEngineFrom does not reproduce an event, the replay
+/// does.
+
+class EventSeeder
+{
+  public:
+    EventSeeder();
+   ~EventSeeder();
+
+    // Master: base seed of the next runs, 0 to draw it from the engine
+    void SetRunSeed(G4long runSeed);
+    // Master: run again the events of a run with the given seed
+    void Replay(G4long runSeed, const std::vector<G4int>& eventIDs);
+
+    // Master, start of run: fix the seed of the run
+    static void BeginOfRun(G4int runID);
+    // Any thread: is the run a replay, and the event ID of its i-th event
+    static G4bool IsReplaying();
+    static G4int ReplayedEventID(G4int i);
+    // Any thread, before the primaries: seed the engine for the event
+    static void SeedEvent(G4int eventID);
+
+  private:
+    SeedMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
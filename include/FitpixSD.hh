@@ -32,7 +32,8 @@
 
 #include "G4VSensitiveDetector.hh"
 
-#include "DUTHit.hh"
+#include "HitStore.hh"
+#include "LayerSlicer.hh"
 
 #include <vector>
 
@@ -41,16 +42,20 @@ class G4HCofThisEvent;
 
 /// Calorimeter sensitive detector class
 ///
-/// In Initialize(), it creates one hit for each calorimeter layer and one more
-/// hit for accounting the total quantities in all layers.
+/// The values are accounted in a per-thread HitStore (one entry per layer and
+/// the sums over the sensor) in ProcessHits() function which is called
+/// by Geant4 kernel at each step. Initialize() clears the store for the new
+/// event and the EventAction reads it at the end of the event.
 ///
-/// The values are accounted in hits in ProcessHits() function which is called
-/// by Geant4 kernel at each step.
+/// With a non-zero sensor thickness the SD is attached to the whole sensor
+/// (virtual layers): the layer is computed from the local z of the step and a
+/// step crossing several layers is split among them along its length.
 
 class FitpixSD : public G4VSensitiveDetector
 {
   public:
-    FitpixSD(const G4String& name, const G4String& hitsCollectionName, G4int nofLayers);
+    FitpixSD(const G4String& name, G4int nofLayers,
+             G4double virtualThickness = 0.);
     virtual ~FitpixSD();
   
     // methods from base class
@@ -58,9 +63,12 @@ class FitpixSD : public G4VSensitiveDetector
     virtual G4bool ProcessHits(G4Step* step, G4TouchableHistory* history);
     virtual void   EndOfEvent(G4HCofThisEvent* hitCollection);
 
+    const HitStore& GetHitStore() const { return fHitStore; }
+
   private:
-    DUTHitsCollection* fHitsCollection;
+    HitStore fHitStore;
     G4int  fNofLayers;
+    LayerSlicer fSlicer;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,145 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file HitStore.hh
+/// \brief Definition of the HitStore class
+
+#ifndef HitStore_h
+#define HitStore_h 1
+
+#include "PadLayout.hh"
+
+#include "G4ThreeVector.hh"
+#include "G4UnitsTable.hh"
+#include "G4ios.hh"
+#include "globals.hh"
+
+#include <array>
+#include <vector>
+
+/// Per-layer energy deposits of one sensor, kept by its sensitive detector
+///
+/// The store replaces a hits collection created for each event: the arrays
+/// (one entry per layer) are allocated once per thread, and Clear() only
+/// zeroes the layers hit in the previous event, which are listed in the
+/// order they were first hit. As in the former hits, the position is the
+/// sum of the deposit positions, not their average.
+
+class HitStore
+{
+  public:
+    HitStore(G4int nofLayers = 0);
+    ~HitStore() {}
+
+    void Clear();
+    void Add(G4int layer, G4double edep, const G4ThreeVector& pos);
+    void AddTotal(G4double edep) { fEdepTotal += edep; }
+    void AddTrackLength(G4double length) { fTrackLength += length; }
+    void AddLarge(G4double edep) { fEdepLarge += edep; }
+    void AddSmall(G4double edep) { fEdepSmall += edep; }
+    void AddPad(G4int pad, G4double edep) { fPadEdep[pad] += edep; }
+
+    G4int GetNofLayers() const                 { return G4int(fEdep.size()); }
+    const std::vector<G4int>& GetTouched() const { return fTouched; }
+    G4double GetEdep(G4int layer) const        { return fEdep[layer]; }
+    G4ThreeVector GetPos(G4int layer) const
+      { return G4ThreeVector(fPosX[layer], fPosY[layer], fPosZ[layer]); }
+    G4double GetEdepTotal() const              { return fEdepTotal; }
+    G4double GetTrackLength() const            { return fTrackLength; }
+    G4double GetEdepLarge() const              { return fEdepLarge; }
+    G4double GetEdepSmall() const              { return fEdepSmall; }
+    G4double GetPadEdep(G4int pad) const       { return fPadEdep[pad]; }
+
+    void Print() const;
+
+  private:
+    // structure of arrays, indexed by layer
+    std::vector<G4double> fEdep;
+    std::vector<G4double> fPosX;
+    std::vector<G4double> fPosY;
+    std::vector<G4double> fPosZ;
+    std::vector<char>     fIsTouched;
+    std::vector<G4int>    fTouched;
+    // sums over the sensor
+    G4double fEdepTotal;
+    G4double fTrackLength;   ///< charged track length
+    G4double fEdepLarge;   ///< large pad region (DUTs only)
+    G4double fEdepSmall;   ///< small pad region (DUTs only)
+    std::array<G4double, PadLayout::kNofPads> fPadEdep;   ///< per pad (DUTs only)
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline HitStore::HitStore(G4int nofLayers)
+ : fEdep(nofLayers, 0.),
+   fPosX(nofLayers, 0.),
+   fPosY(nofLayers, 0.),
+   fPosZ(nofLayers, 0.),
+   fIsTouched(nofLayers, 0),
+   fEdepTotal(0.),
+   fTrackLength(0.),
+   fEdepLarge(0.),
+   fEdepSmall(0.)
+{
+  fPadEdep.fill(0.);
+  fTouched.reserve(nofLayers);
+}
+
+inline void HitStore::Clear()
+{
+  for ( auto layer : fTouched ) {
+    fEdep[layer] = fPosX[layer] = fPosY[layer] = fPosZ[layer] = 0.;
+    fIsTouched[layer] = 0;
+  }
+  fTouched.clear();
+  fEdepTotal = fTrackLength = fEdepLarge = fEdepSmall = 0.;
+  fPadEdep.fill(0.);
+}
+
+inline void HitStore::Add(G4int layer, G4double edep, const G4ThreeVector& pos)
+{
+  if ( ! fIsTouched[layer] ) {
+    fIsTouched[layer] = 1;
+    fTouched.push_back(layer);
+  }
+  fEdep[layer] += edep;
+  fPosX[layer] += pos.x();
+  fPosY[layer] += pos.y();
+  fPosZ[layer] += pos.z();
+}
+
+inline void HitStore::Print() const
+{
+  G4cout << "   " << fTouched.size() << " layers hit, total edep: "
+         << G4BestUnit(fEdepTotal, "Energy") << G4endl;
+  for ( auto layer : fTouched ) {
+    G4cout << "     layer " << layer << " edep: " << G4BestUnit(fEdep[layer], "Energy")
+           << " position sum: " << GetPos(layer) << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
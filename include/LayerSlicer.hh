@@ -0,0 +1,117 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file LayerSlicer.hh
+/// \brief Definition of the LayerSlicer class
+
+#ifndef LayerSlicer_h
+#define LayerSlicer_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <cmath>
+
+/// Virtual depth segmentation of a single solid sensor
+///
+/// The sensor is a slab of the given thickness centred on its local origin,
+/// layer 0 being the one at local z = +thickness/2, i.e. the face hit first
+/// by the beam. Slice() walks the straight segment between the local pre- and
+/// post-step points and calls back once for each crossed layer with the
+/// fraction of the segment inside it and the segment parameters [t0, t1].
+
+class LayerSlicer
+{
+  public:
+    LayerSlicer(G4int nofLayers = 0, G4double thickness = 0.);
+    ~LayerSlicer() {}
+
+    G4bool   IsActive() const       { return fNofLayers > 0; }
+    G4int    GetNofLayers() const   { return fNofLayers; }
+    G4double GetThickness() const   { return fThickness; }
+
+    G4int LayerOf(G4double localZ) const;
+
+    template <typename Func>
+    void Slice(const G4ThreeVector& localPre, const G4ThreeVector& localPost,
+               Func&& func) const;
+
+  private:
+    G4int    fNofLayers;
+    G4double fThickness;
+    G4double fLayerThickness;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline LayerSlicer::LayerSlicer(G4int nofLayers, G4double thickness)
+ : fNofLayers(thickness > 0. ? nofLayers : 0),
+   fThickness(thickness),
+   fLayerThickness(nofLayers > 0 ? thickness/nofLayers : 0.)
+{}
+
+inline G4int LayerSlicer::LayerOf(G4double localZ) const
+{
+  auto depth = fThickness/2 - localZ;
+  auto layer = G4int(std::floor(depth/fLayerThickness));
+  // points on (or rounded just past) the faces belong to the outer layers
+  if ( layer < 0 ) return 0;
+  if ( layer >= fNofLayers ) return fNofLayers-1;
+  return layer;
+}
+
+template <typename Func>
+inline void LayerSlicer::Slice(const G4ThreeVector& localPre,
+                               const G4ThreeVector& localPost,
+                               Func&& func) const
+{
+  auto firstLayer = LayerOf(localPre.z());
+  auto lastLayer  = LayerOf(localPost.z());
+  if ( firstLayer == lastLayer ) {
+    func(firstLayer, 1., 0., 1.);
+    return;
+  }
+
+  // Depth along the segment is linear in t, so each layer boundary crossed
+  // gives one split point
+  auto depthPre  = fThickness/2 - localPre.z();
+  auto depthPost = fThickness/2 - localPost.z();
+  G4int direction = (lastLayer > firstLayer) ? 1 : -1;
+  G4double t = 0.;
+  for ( G4int layer = firstLayer; layer != lastLayer; layer += direction ) {
+    auto boundary = (direction > 0 ? layer+1 : layer) * fLayerThickness;
+    auto tNext = (boundary - depthPre) / (depthPost - depthPre);
+    if ( tNext < t ) tNext = t;
+    if ( tNext > 1. ) tNext = 1.;
+    if ( tNext > t ) func(layer, tNext - t, t, tNext);
+    t = tNext;
+  }
+  if ( t < 1. ) func(lastLayer, 1. - t, t, 1.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
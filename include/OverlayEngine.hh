@@ -0,0 +1,116 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file OverlayEngine.hh
+/// \brief Definition of the OverlayEngine class
+
+#ifndef OverlayEngine_h
+#define OverlayEngine_h 1
+
+#include "EventRecord.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+class OverlayMessenger;
+
+/// One row of an overlay library file. A library entry (one single-primary
+/// event) is a contiguous set of rows: one row with the primary energy
+/// (sensor kEvent) and one row per non-empty layer or sum of each sensor.
+
+struct OverlayRecord
+{
+  std::int32_t entry;    ///< event ID in the library building run
+  std::int16_t sensor;   ///< 0 DUT A, 1 DUT B, 2 Fitpix, 3 event
+  std::int16_t layer;    ///< layer, or kTotal, kLarge, kSmall, kPad - pad index
+  float edep;            ///< energy deposit (primary energy for sensor 3)
+  float x, y, z;         ///< summed deposit positions (x: track length for kTotal)
+};
+
+const char          kOverlayMagic[]  = "BTFOVLY";
+const std::uint32_t kOverlayVersion  = 3;
+
+/// Pile-up by overlay of pre-simulated single-primary events
+///
+/// In building mode the record of each event is appended to the library
+/// file of the thread (the run must be done with multiplicity 1).
+/// In overlay mode no particle is transported: for each event the primary
+/// generator draws the bunch multiplicity, Draw() picks as many library
+/// entries at random and EndOfEvent() adds them to the event record, which
+/// is then written out as a normal event. The primary energy histogram gets
+/// the energy of the first entry; the primaryUp/Down histograms, filled
+/// during the transport, stay empty.
+
+class OverlayEngine
+{
+  public:
+    OverlayEngine();
+    ~OverlayEngine();
+
+    void SetLibraryToBuild(const G4String& fileName);
+    void SetLibraryToUse(const G4String& fileName);
+
+    G4bool IsBuilding() const   { return fFile.is_open(); }
+    G4bool IsOverlaying() const { return fLibrary != nullptr; }
+
+    void Draw(G4int multiplicity);
+    void EndOfEvent(EventRecord& record);
+
+    enum { kDutA = 0, kDutB = 1, kFitpix = 2, kEvent = 3 };
+    enum { kTotal = -1, kLarge = -2, kSmall = -3, kPad = -4 };
+
+    // Rows of the library format for one event record
+    static void AppendRows(const EventRecord& record, std::vector<OverlayRecord>& rows);
+
+  private:
+    struct Library {
+      std::vector<OverlayRecord> records;
+      std::vector<std::size_t>   entryStart;
+    };
+    static std::shared_ptr<const Library> Load(const G4String& fileName);
+
+    void Write(const EventRecord& record);
+    void AddEntries(EventRecord& record);
+
+    OverlayMessenger*              fMessenger;
+    std::ofstream                  fFile;
+    std::shared_ptr<const Library> fLibrary;
+    std::vector<std::size_t>       fDrawn;
+
+    // Dense per-layer sums of the drawn entries, one per sensor
+    struct Accumulator {
+      std::vector<G4double>      edep;
+      std::vector<G4ThreeVector> pos;
+      std::vector<G4int>         touched;
+    };
+    Accumulator fSums[3];
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
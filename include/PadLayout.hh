@@ -0,0 +1,132 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file PadLayout.hh
+/// \brief Definition of the pad layout of the sapphire sensors
+
+#ifndef PadLayout_h
+#define PadLayout_h 1
+
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+
+#include <array>
+#include <cstdint>
+
+/// Readout pads of the sapphire wafers, in the wafer frame
+///
+/// The table is used by DetectorConstruction to place the pad
+/// metallizations and by DUTSD to score the energy per pad. A step is
+/// assigned to a pad with FindPad(): the wafer plane around the pads is cut
+/// in square cells and each cell stores, at compile time, the only pad that
+/// can contain points of the cell, so that a single distance test is needed
+/// whatever the number of pads.
+
+struct PadDefinition
+{
+  G4int    fNumber;     ///< pad number, 1 to 4 for each size
+  G4bool   fLarge;      ///< large (5.50 mm) or small (1.60 mm) pad
+  G4double fX;
+  G4double fY;
+  G4double fRadius;
+  G4bool   fBottom;     ///< metallized on the bottom face as well
+};
+
+namespace PadLayout
+{
+  constexpr G4double kLargeRadius = 5.50/2*mm;
+  constexpr G4double kSmallRadius = 1.60/2*mm;
+
+  constexpr G4int kNofPads = 8;
+  constexpr PadDefinition kPads[kNofPads] = {
+    { 1, true,  -10.5*mm, -15*mm, kLargeRadius, true  },
+    { 2, true,   10.5*mm, -15*mm, kLargeRadius, true  },
+    { 3, true,   10.5*mm,  15*mm, kLargeRadius, false },
+    { 4, true,  -10.5*mm,  15*mm, kLargeRadius, false },
+    { 1, false,  -5.0*mm, -20*mm, kSmallRadius, true  },
+    { 2, false,   5.0*mm, -20*mm, kSmallRadius, true  },
+    { 3, false,   5.0*mm,  20*mm, kSmallRadius, false },
+    { 4, false,  -5.0*mm,  20*mm, kSmallRadius, false }
+  };
+  // The small pad 4 is the one aligned on the beam axis
+  constexpr G4int kBeamPad = 7;
+
+  // Lookup grid
+  constexpr G4double kCellSize = 0.5*mm;
+  constexpr G4double kGridX0 = -14*mm;
+  constexpr G4double kGridY0 = -22*mm;
+  constexpr G4int    kNofCellsX = 56;
+  constexpr G4int    kNofCellsY = 88;
+
+  using Grid = std::array<std::int8_t, kNofCellsX*kNofCellsY>;
+
+  constexpr G4double Clamp(G4double value, G4double low, G4double high)
+  {
+    return value < low ? low : (value > high ? high : value);
+  }
+
+  constexpr Grid MakeGrid()
+  {
+    Grid grid {};
+    for ( G4int iy = 0; iy < kNofCellsY; ++iy ) {
+      for ( G4int ix = 0; ix < kNofCellsX; ++ix ) {
+        auto x0 = kGridX0 + ix*kCellSize;
+        auto y0 = kGridY0 + iy*kCellSize;
+        std::int8_t candidate = -1;
+        for ( G4int pad = 0; pad < kNofPads; ++pad ) {
+          // distance from the pad centre to the closest point of the cell
+          auto dx = Clamp(kPads[pad].fX, x0, x0 + kCellSize) - kPads[pad].fX;
+          auto dy = Clamp(kPads[pad].fY, y0, y0 + kCellSize) - kPads[pad].fY;
+          if ( dx*dx + dy*dy >= kPads[pad].fRadius*kPads[pad].fRadius ) continue;
+          // two pads in one cell would need a finer grid
+          if ( candidate >= 0 ) throw "PadLayout: pads closer than the grid cell size";
+          candidate = pad;
+        }
+        grid[iy*kNofCellsX + ix] = candidate;
+      }
+    }
+    return grid;
+  }
+
+  constexpr Grid kGrid = MakeGrid();
+
+  /// Index in kPads of the pad containing the point (x, y) of the wafer
+  /// plane, or -1
+  inline G4int FindPad(G4double x, G4double y)
+  {
+    auto ix = G4int((x - kGridX0)/kCellSize);
+    auto iy = G4int((y - kGridY0)/kCellSize);
+    if ( x < kGridX0 || y < kGridY0 || ix >= kNofCellsX || iy >= kNofCellsY ) return -1;
+    G4int pad = kGrid[iy*kNofCellsX + ix];
+    if ( pad < 0 ) return -1;
+    auto dx = x - kPads[pad].fX;
+    auto dy = y - kPads[pad].fY;
+    return ( dx*dx + dy*dy < kPads[pad].fRadius*kPads[pad].fRadius ) ? pad : -1;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,52 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file PhaseSpace.hh
+/// \brief Record layout of the phase-space files
+
+#ifndef PhaseSpace_h
+#define PhaseSpace_h 1
+
+#include <cstdint>
+
+/// One particle crossing the scoring plane in front of the DUT box.
+/// Lengths in mm, energies in MeV, time in ns (Geant4 internal units).
+/// An event where no particle reached the plane is written as one marker
+/// record with pdg 0, so that every recorded event has a group at replay.
+
+struct PhaseSpaceRecord
+{
+  std::int32_t event;       ///< event ID in the recording run
+  std::int32_t pdg;         ///< PDG encoding, 0 for an empty event
+  float x, y, z;            ///< global position on the plane
+  float dx, dy, dz;         ///< momentum direction
+  float ekin;               ///< kinetic energy
+  float time;               ///< global time
+};
+
+const char          kPhaseSpaceMagic[]  = "BTFPHSP";
+const std::uint32_t kPhaseSpaceVersion  = 2;
+
+#endif
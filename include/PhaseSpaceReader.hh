@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm4/include/PhaseSpaceReader.hh
+/// \brief Definition of the PhaseSpaceReader class
+
+#ifndef PhaseSpaceReader_h
+#define PhaseSpaceReader_h 1
+
+#include "G4VPrimaryGenerator.hh"
+#include "globals.hh"
+
+#include "PhaseSpace.hh"
+
+#include <memory>
+#include <vector>
+
+class G4Event;
+
+/// Primary generator replaying a phase-space file written by PhaseSpaceSD
+///
+/// The particles recorded in one event of the recording run form a group,
+/// indexed by the recorded event ID (an event where nothing reached the
+/// plane has an empty group); GenerateGroup() adds one group to the event.
+/// The caller chooses the group from the event ID, so that the replay does
+/// not depend on threads; GeneratePrimaryVertex() adds the group of the
+/// event ID. A group that was not recorded (past the end of the recording)
+/// is a fatal error, as is an event ID recorded twice (e.g. two recording
+/// runs in the same file). The file content is loaded once and shared by
+/// all the worker threads.
+
+class PhaseSpaceReader : public G4VPrimaryGenerator
+{
+  public:
+    PhaseSpaceReader(const G4String& fileName);
+    virtual ~PhaseSpaceReader();
+
+    virtual void GeneratePrimaryVertex(G4Event* event);
+
+    // Add the group of the given recorded event ID to the event
+    void GenerateGroup(G4Event* event, std::size_t group) const;
+
+    std::size_t GetNofGroups() const { return fData->nofGroups; }
+
+  private:
+    struct Data {
+      std::vector<PhaseSpaceRecord> records;
+      std::vector<std::size_t>      groupStart;   //by event ID, kNoGroup if not recorded
+      std::vector<std::size_t>      groupEnd;
+      std::size_t                   nofGroups = 0;
+    };
+    static constexpr std::size_t kNoGroup = std::size_t(-1);
+    static std::shared_ptr<const Data> Load(const G4String& fileName);
+
+    std::shared_ptr<const Data> fData;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
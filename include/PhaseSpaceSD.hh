@@ -0,0 +1,75 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceSD.hh
+/// \brief Definition of the PhaseSpaceSD class
+
+#ifndef PhaseSpaceSD_h
+#define PhaseSpaceSD_h 1
+
+#include "G4VSensitiveDetector.hh"
+
+#include "PhaseSpace.hh"
+
+#include <fstream>
+#include <vector>
+
+class G4Step;
+
+/// Phase-space recording sensitive detector
+///
+/// Attached to the scoring plane in front of the DUT box. Each particle
+/// entering the plane on its way downstream is written to the phase-space
+/// file of the thread and then killed, since the DUT part of the event is
+/// what the replay runs are for.
+///
+/// An event without any particle on the plane gets a marker record (see
+/// PhaseSpace.hh), written in EndOfEvent(). The records are buffered and
+/// written in blocks; Flush() is called by RunAction at the end of each run.
+
+class PhaseSpaceSD : public G4VSensitiveDetector
+{
+  public:
+    PhaseSpaceSD(const G4String& name, const G4String& fileName);
+    virtual ~PhaseSpaceSD();
+  
+    // methods from base class
+    virtual void   Initialize(G4HCofThisEvent*);
+    virtual G4bool ProcessHits(G4Step* step, G4TouchableHistory* history);
+    virtual void   EndOfEvent(G4HCofThisEvent*);
+
+    void Flush();
+
+  private:
+    std::ofstream                 fFile;
+    std::vector<PhaseSpaceRecord> fBuffer;
+    G4bool                        fEventRecorded;   //a particle of the event was written
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
+
@@ -0,0 +1,72 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm4/include/PhysicsList.hh
+/// \brief Definition of the PhysicsList class
+//
+//
+//
+// 
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PhysicsList_h
+#define PhysicsList_h 1
+
+#include "G4VModularPhysicsList.hh"
+#include "globals.hh"
+
+class PhysicsListMessenger;
+
+/// Electromagnetic-only physics list
+///
+/// Alternative to FTFP_BERT (selected with the -p option of TestEm4) for
+/// the electron beam on the thin sensors, where the hadronic part mostly
+/// costs initialization time and memory. The EM constructor is one of
+/// emstandard, emstandard_opt3, emstandard_opt4 (default) and emlivermore,
+/// and can be changed in PreInit with /btf/phys/addPhysics. Decays are
+/// kept; the production cuts are the default ones, as in FTFP_BERT.
+
+class PhysicsList: public G4VModularPhysicsList
+{
+  public:
+    PhysicsList(const G4String& emName = "emstandard_opt4");
+   ~PhysicsList();
+
+    void AddPhysicsList(const G4String& name);
+
+    static G4bool IsEmPhysicsName(const G4String& name);
+
+  private:
+    G4VPhysicsConstructor* MakeEmPhysics(const G4String& name) const;
+
+    G4String              fEmName;
+    PhysicsListMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
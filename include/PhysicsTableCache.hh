@@ -0,0 +1,88 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm4/include/PhysicsTableCache.hh
+/// \brief Definition of the PhysicsTableCache class
+//
+//
+//
+// 
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PhysicsTableCache_h
+#define PhysicsTableCache_h 1
+
+#include "G4VStateDependent.hh"
+#include "globals.hh"
+
+class G4VModularPhysicsList;
+class PhysicsTableCacheMessenger;
+
+/// Cache of the physics tables on disk, for a fast start of batch jobs
+///
+/// With /btf/phys/tableCache <dir>, each set of tables is kept in
+/// <dir>/<key>, where the key is a hash of the physics constructors, the
+/// production cuts of all the regions, the materials, the EM parameters
+/// (/process/em, /process/msc, /process/eLoss options) and the Geant4
+/// version. The full description is stored with the tables and compared
+/// when reading them, so any change of these inputs gives a new entry.
+///
+/// The cache works on the master (or sequential) thread only: when a run
+/// starts (state Idle -> Init, before the tables are built) it asks the
+/// physics list to retrieve the tables of the current key if they exist,
+/// and stores them once built (Init -> Idle) otherwise. The tables are
+/// first written to a temporary directory which is then renamed, so that
+/// concurrent jobs never see an incomplete entry. Only the processes able
+/// to store their tables (electromagnetic ones) use the cache: the hadronic
+/// processes of FTFP_BERT are initialized as usual.
+
+class PhysicsTableCache : public G4VStateDependent
+{
+  public:
+    PhysicsTableCache(G4VModularPhysicsList* physicsList);
+    virtual ~PhysicsTableCache();
+
+    virtual G4bool Notify(G4ApplicationState requestedState);
+
+    void SetDirectory(const G4String& dir) { fDirectory = dir; }
+
+  private:
+    G4String Describe() const;
+    G4String EntryName(const G4String& description) const;
+    G4bool   IsStored(const G4String& entry, const G4String& description) const;
+    void     Store(const G4String& entry, const G4String& description) const;
+
+    G4VModularPhysicsList*      fPhysicsList;
+    PhysicsTableCacheMessenger* fMessenger;
+    G4String fDirectory;
+    G4String fPendingEntry;        ///< entry to store once the tables are built
+    G4String fPendingDescription;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
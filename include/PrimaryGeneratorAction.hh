@@ -34,6 +34,8 @@
 #include "globals.hh"
 
 class G4GeneralParticleSource;
+class PhaseSpaceReader;
+class OverlayEngine;
 class PrimaryGeneratorMessenger;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -41,17 +43,26 @@ class PrimaryGeneratorMessenger;
 class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
   public:
-    PrimaryGeneratorAction();    
+    PrimaryGeneratorAction(OverlayEngine* overlay = nullptr);    
     virtual ~PrimaryGeneratorAction();
 
     virtual void GeneratePrimaries(G4Event* event);
     void SetBeamMultiplicity(G4int beamMultiplicity);
+    void SetPoissonMultiplicity(G4bool poisson) { fPoissonMultiplicity = poisson; }
+    void SetSubEvents(G4int nofSubEvents) { fSubEvents = nofSubEvents; }
+    void SetFirstEvent(G4int firstEvent) { fFirstEvent = firstEvent; }
+    void SetPhaseSpaceFile(const G4String& fileName);
 
   private:
     G4GeneralParticleSource*  fParticleGun;        //pointer a to G4 service class
+    PhaseSpaceReader*          fPhaseSpace;        //replayed phase space, if any
+    OverlayEngine*             fOverlay;           //overlay of library entries, if any
     PrimaryGeneratorMessenger* fGunMessenger;
 
     G4int fBeamMultiplicity;                       //beam multiplicity
+    G4bool fPoissonMultiplicity;                   //multiplicity is the Poisson mean
+    G4int fSubEvents;                              //number of events per bunch
+    G4int fFirstEvent;                             //event ID of the first event of the run
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -42,6 +42,8 @@
 class PrimaryGeneratorAction;
 class G4UIdirectory;
 class G4UIcmdWithAnInteger;
+class G4UIcmdWithAString;
+class G4UIcmdWithABool;
 
 
 class PrimaryGeneratorMessenger: public G4UImessenger
@@ -56,6 +58,10 @@ class PrimaryGeneratorMessenger: public G4UImessenger
     PrimaryGeneratorAction*    fAction;
     G4UIdirectory*             fGunDir;
     G4UIcmdWithAnInteger*      fBeamMultiplicity;
+    G4UIcmdWithABool*          fPoissonCmd;
+    G4UIcmdWithAnInteger*      fSubEventsCmd;
+    G4UIcmdWithAnInteger*      fFirstEventCmd;
+    G4UIcmdWithAString*        fPhaseSpaceCmd;
 };
 
 #endif
\ No newline at end of file
@@ -38,9 +38,18 @@
 #include "G4UserRunAction.hh"
 #include "globals.hh"
 
+#include <chrono>
+#include <vector>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class G4Run;
+class RunMessenger;
+class StackingAction;
+class SteppingAction;
+class StepProfiler;
+class StepTracer;
+class TrackingAction;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -53,6 +62,46 @@ class RunAction : public G4UserRunAction
   public:
     virtual void BeginOfRunAction(const G4Run*);
     virtual void   EndOfRunAction(const G4Run*);
+
+    void SetAsyncFile(const G4String& fileName) { fAsyncFile = fileName; }
+    void SetEventSchema(G4bool eventSchema) { fEventSchema = eventSchema; }
+    G4bool GetEventSchema() const { return fEventSchema; }
+
+    // Worker: stacking action whose kill counts are added up at the end of run
+    void SetStackingAction(StackingAction* stackingAction) { fStackingAction = stackingAction; }
+    // Worker: step profiler whose tables are added up at the end of run
+    void SetStepProfiler(StepProfiler* profiler) { fStepProfiler = profiler; }
+    // Worker: stepping action, registered to the kernel for the runs that
+    // need it (profiler or tracer enabled)
+    void SetSteppingAction(SteppingAction* steppingAction) { fSteppingAction = steppingAction; }
+    // Worker: binary step trace written out at the end of run
+    void SetStepTracer(StepTracer* tracer) { fStepTracer = tracer; }
+    // Worker: secondary census added up at the end of run
+    void SetTrackingAction(TrackingAction* trackingAction) { fTrackingAction = trackingAction; }
+
+    // Wafer IDs, index of the per-wafer columns of the event-wise ntuple
+    enum { kWafer110um = 0, kWafer150um = 1, kNofWafers = 2 };
+
+    // Per-layer columns of the event-wise ntuple, filled by the EventAction
+    std::vector<G4double>& GetLayerEdep(G4int wafer) { return fLayerEdep[wafer]; }
+    std::vector<G4double>& GetLayerPosX(G4int wafer) { return fLayerPosX[wafer]; }
+    std::vector<G4double>& GetLayerPosY(G4int wafer) { return fLayerPosY[wafer]; }
+    std::vector<G4double>& GetLayerPosZ(G4int wafer) { return fLayerPosZ[wafer]; }
+
+  private:
+    RunMessenger* fRunMessenger;
+    G4String      fAsyncFile;     //asynchronous event output, if any
+    G4bool        fEventSchema;   //one ntuple row per event and wafer
+    StackingAction* fStackingAction; //worker: track-killing rules
+    SteppingAction* fSteppingAction; //worker: profiler and tracer hooks
+    StepProfiler*   fStepProfiler;   //worker: step and time profile
+    TrackingAction* fTrackingAction; //worker: secondary census
+    StepTracer*     fStepTracer;     //worker: binary step trace
+    std::chrono::steady_clock::time_point fRunStart;   //wall time of the run (master) or event loop (worker) start
+    std::vector<G4double> fLayerEdep[kNofWafers];
+    std::vector<G4double> fLayerPosX[kNofWafers];
+    std::vector<G4double> fLayerPosY[kNofWafers];
+    std::vector<G4double> fLayerPosZ[kNofWafers];
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,101 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file RunTotals.hh
+/// \brief Definition of the RunTotals class
+
+#ifndef RunTotals_h
+#define RunTotals_h 1
+
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+/// Run totals shared by the threads, by key
+///
+/// The workers add their counts at the end of the run with Update(), which
+/// hands the map to the given function under the lock (state kept next to
+/// the totals can be updated there too); the master then takes the totals
+/// out with Take(), which leaves them empty for the next run. SortedRows()
+/// orders the taken totals for printing, largest first.
+
+template <typename Key, typename Value>
+class RunTotals
+{
+  public:
+    using Map = std::map<Key, Value>;
+    using Row = std::pair<Key, Value>;
+
+    template <typename Func>
+    void Update(Func func);
+    Map  Take();
+
+    template <typename Measure>
+    static std::vector<Row> SortedRows(const Map& totals, Measure measure);
+
+  private:
+    G4Mutex fMutex;
+    Map     fTotals;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <typename Key, typename Value>
+template <typename Func>
+inline void RunTotals<Key, Value>::Update(Func func)
+{
+  G4AutoLock lock(&fMutex);
+  func(fTotals);
+}
+
+template <typename Key, typename Value>
+inline typename RunTotals<Key, Value>::Map RunTotals<Key, Value>::Take()
+{
+  G4AutoLock lock(&fMutex);
+  Map totals;
+  totals.swap(fTotals);
+  return totals;
+}
+
+template <typename Key, typename Value>
+template <typename Measure>
+inline std::vector<typename RunTotals<Key, Value>::Row>
+RunTotals<Key, Value>::SortedRows(const Map& totals, Measure measure)
+{
+  std::vector<Row> rows(totals.begin(), totals.end());
+  std::stable_sort(rows.begin(), rows.end(),
+                   [&measure](const Row& a, const Row& b)
+                   { return measure(a.second) > measure(b.second); });
+  return rows;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,89 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ScanEngine.hh
+/// \brief Definition of the ScanEngine class
+
+#ifndef ScanEngine_h
+#define ScanEngine_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class ScanMessenger;
+
+/// Parameter scan in one process (/btf/scan/run <specFile>)
+///
+/// Each point of the scan is a run of the same (initialized) application:
+/// before the run, only the parameters whose value differs from the
+/// previous point are applied, so a geometry parameter such as
+/// /btf/det/dutPosition moves the volumes only when it changes, and the
+/// physics tables are only rebuilt if a production cut changes. Each point
+/// writes <output>_<label>.root and a line of <output>.csv (label, values,
+/// events, wall time). The specification file reads:
+///
+///   events 10000                          # events (bunches) per point
+///   output scan                           # base name of the outputs
+///   param energy /gps/energy {} MeV       # name and command, {} = value
+///   param dutX   /btf/det/dutPosition {} 0 mm
+///   point e450_x0   450  0                # label and one value per param
+///   point e450_x5   450  5
+///
+/// Blank lines and text after '#' are ignored.
+
+class ScanEngine
+{
+  public:
+    ScanEngine();
+   ~ScanEngine();
+
+    // Master: read the specification and run all its points
+    void Run(const G4String& specFile);
+
+  private:
+    struct Parameter {
+      G4String fName;
+      G4String fCommand;
+    };
+    struct Point {
+      G4String              fLabel;
+      std::vector<G4String> fValues;
+    };
+
+    G4bool Read(const G4String& specFile);
+    G4bool Apply(const G4String& command) const;
+
+    ScanMessenger*         fMessenger;
+    G4int                  fNofEvents;
+    G4String               fOutput;
+    std::vector<Parameter> fParameters;
+    std::vector<Point>     fPoints;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,157 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SensorKernels.hh
+/// \brief Scoring kernels of the sensitive detectors and of the EventAction
+
+#ifndef SensorKernels_h
+#define SensorKernels_h 1
+
+#include "EventRecord.hh"
+#include "HitStore.hh"
+#include "LayerSlicer.hh"
+#include "PadLayout.hh"
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <algorithm>
+#include <vector>
+
+/// One step in a sensor, as seen by the scoring: the global pre- and
+/// post-step points, the same points in the sensor frame and the layer of
+/// the pre-step point (the copy number, or the virtual layer). The step
+/// length is that of charged particles only, zero for neutrals.
+/// The local points are only needed with virtual layers or pads.
+
+struct SensorStep
+{
+  G4double      fEdep;
+  G4double      fStepLength;
+  G4ThreeVector fPrePos;
+  G4ThreeVector fPostPos;
+  G4ThreeVector fLocalPre;
+  G4ThreeVector fLocalPost;
+  G4int         fLayer;
+};
+
+/// The hot loops of the scoring, free of the Geant4 kernel: DUTSD and
+/// FitpixSD call AddLayers() (and AddPads() for the DUTs) from ProcessHits(),
+/// the EventAction calls FillSensorRecord() and FillLayerColumns() at the end
+/// of the event. sdbench feeds them synthetic steps to time them alone.
+
+namespace SensorKernels
+{
+  /// Per-layer deposits and total: the step goes to its layer, or is shared
+  /// among the virtual layers crossed, proportionally to the path
+  inline void AddLayers(HitStore& store, const LayerSlicer& slicer, const SensorStep& step)
+  {
+    if ( slicer.IsActive() ) {
+      slicer.Slice(step.fLocalPre, step.fLocalPost,
+        [&](G4int layer, G4double fraction, G4double t0, G4double t1) {
+          store.Add(layer, step.fEdep*fraction,
+                    step.fPrePos + (t0+t1)/2*(step.fPostPos-step.fPrePos));
+        });
+    }
+    else {
+      store.Add(step.fLayer, step.fEdep, (step.fPostPos + step.fPrePos)/2);
+    }
+    store.AddTotal(step.fEdep);
+    store.AddTrackLength(step.fStepLength);
+  }
+
+  /// Large and small pad sums (circles of the pad sizes around the beam
+  /// axis) and pad readout, from the grid of the pad layout
+  inline void AddPads(HitStore& store, const SensorStep& step)
+  {
+    auto edepPos = (step.fPostPos + step.fPrePos)/2;
+    auto planeRadius2 = edepPos.perp2();
+    auto planeRadius2Pre = step.fPrePos.perp2();
+    auto planeRadius2Post = step.fPostPos.perp2();
+    auto largePadRadius2 = PadLayout::kLargeRadius*PadLayout::kLargeRadius;
+    auto smallPadRadius2 = PadLayout::kSmallRadius*PadLayout::kSmallRadius;
+    if(planeRadius2 < largePadRadius2 && planeRadius2Pre < largePadRadius2 && planeRadius2Post < largePadRadius2){
+      store.AddLarge(step.fEdep);
+    }
+    if(planeRadius2 <= smallPadRadius2){
+      store.AddSmall(step.fEdep);
+    }
+
+    // the transformation is affine: the local mid-point is the mid-point
+    // of the local points
+    auto localPos = (step.fLocalPre + step.fLocalPost)/2;
+    auto pad = PadLayout::FindPad(localPos.x(), localPos.y());
+    if ( pad >= 0 ) store.AddPad(pad, step.fEdep);
+  }
+
+  /// Event record of one sensor from its hit store
+  inline void FillSensorRecord(const HitStore& store, SensorRecord& record, G4bool withPads)
+  {
+    record.Clear();
+    record.fNofLayers = store.GetNofLayers();
+    record.fEdep = store.GetEdepTotal();
+    record.fTrackLength = store.GetTrackLength();
+    // Only the layers hit are visited, in increasing order for the record
+    for(auto layer : store.GetTouched()){
+      if(store.GetEdep(layer) == 0) continue;
+      record.fLayers.push_back({layer, store.GetEdep(layer), store.GetPos(layer)});
+    }
+    std::sort(record.fLayers.begin(), record.fLayers.end(),
+              [](const LayerDeposit& a, const LayerDeposit& b) { return a.fLayer < b.fLayer; });
+    if ( withPads ) {
+      // The pad sums also follow the layers in the DUTs ntuple, as layers
+      // nofLayers+1 and nofLayers+2
+      record.fEdepLarge = store.GetEdepLarge();
+      record.fEdepSmall = store.GetEdepSmall();
+      for(G4int pad = 0; pad < PadLayout::kNofPads; ++pad) record.fPadEdep[pad] = store.GetPadEdep(pad);
+      if(record.fEdepLarge != 0) record.fLayers.push_back({record.fNofLayers, record.fEdepLarge, G4ThreeVector()});
+      if(record.fEdepSmall != 0) record.fLayers.push_back({record.fNofLayers+1, record.fEdepSmall, G4ThreeVector()});
+    }
+  }
+
+  /// Per-layer columns (keV, mm) of the event-wise ntuple; layers without
+  /// deposit stay at zero and the pad sums are left out
+  inline void FillLayerColumns(const SensorRecord& record,
+                               std::vector<G4double>& edep, std::vector<G4double>& xpos,
+                               std::vector<G4double>& ypos, std::vector<G4double>& zpos)
+  {
+    edep.assign(record.fNofLayers, 0.);
+    xpos.assign(record.fNofLayers, 0.);
+    ypos.assign(record.fNofLayers, 0.);
+    zpos.assign(record.fNofLayers, 0.);
+    for(const auto& deposit : record.fLayers){
+      if(deposit.fLayer >= record.fNofLayers) break;
+      edep[deposit.fLayer] = deposit.fEdep/CLHEP::keV;
+      xpos[deposit.fLayer] = deposit.fPos.x()/CLHEP::mm;
+      ypos[deposit.fLayer] = deposit.fPos.y()/CLHEP::mm;
+      zpos[deposit.fLayer] = deposit.fPos.z()/CLHEP::mm;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,95 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SpscQueue.hh
+/// \brief Definition of the SpscQueue class
+
+#ifndef SpscQueue_h
+#define SpscQueue_h 1
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/// Bounded lock-free queue with a single producer and a single consumer
+///
+/// The capacity is rounded up to a power of two. The producer and the
+/// consumer each own one index; an element is handed over by the release
+/// store of the index following it, so no lock is ever taken.
+
+template <typename T>
+class SpscQueue
+{
+  public:
+    explicit SpscQueue(std::size_t capacity);
+
+    // Producer side: false if the queue is full (the element is not moved)
+    bool TryPush(T& element);
+    // Consumer side: false if the queue is empty
+    bool TryPop(T& element);
+
+  private:
+    std::vector<T> fSlots;
+    std::size_t    fMask;
+    // the two indices are written by different threads: keep them apart
+    alignas(64) std::atomic<std::size_t> fHead;   ///< next slot to pop
+    alignas(64) std::atomic<std::size_t> fTail;   ///< next slot to push
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <typename T>
+inline SpscQueue<T>::SpscQueue(std::size_t capacity)
+ : fHead(0), fTail(0)
+{
+  std::size_t size = 2;
+  while ( size < capacity ) size *= 2;
+  fSlots.resize(size);
+  fMask = size - 1;
+}
+
+template <typename T>
+inline bool SpscQueue<T>::TryPush(T& element)
+{
+  auto tail = fTail.load(std::memory_order_relaxed);
+  if ( tail - fHead.load(std::memory_order_acquire) > fMask ) return false;
+  fSlots[tail & fMask] = std::move(element);
+  fTail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+inline bool SpscQueue<T>::TryPop(T& element)
+{
+  auto head = fHead.load(std::memory_order_relaxed);
+  if ( head == fTail.load(std::memory_order_acquire) ) return false;
+  element = std::move(fSlots[head & fMask]);
+  fHead.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,110 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StackingAction.hh
+/// \brief Definition of the StackingAction class
+
+#ifndef StackingAction_h
+#define StackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4ParticleDefinition;
+class G4Region;
+class StackingMessenger;
+
+/// Track-killing policy for the secondaries
+///
+/// The rules are set with the /btf/stack/ commands and tried in order on
+/// each new secondary; the first one that applies kills it:
+/// - minEkin: kinetic energy below a threshold, for one particle (or all)
+///   created in one region (or anywhere)
+/// - acceptance: neutral particle not heading within a cone of given half
+///   angle around the direction to a target point (by default the DUT box,
+///   taken from the detector at the start of each run so that it follows
+///   /btf/det/dutPosition)
+/// - maxTime: global time beyond a cutoff
+///
+/// Each thread counts the tracks and the kinetic energy killed by each rule.
+/// EndOfRun() adds them to the totals shared by the threads, which the master
+/// prints with PrintKills() at the end of the run.
+
+class StackingAction : public G4UserStackingAction
+{
+  public:
+    StackingAction();
+    virtual ~StackingAction();
+
+    virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track);
+
+    void AddMinEkinRule(const G4String& particle, const G4String& region, G4double minEkin);
+    void AddAcceptanceRule(G4double halfAngle);
+    void AddMaxTimeRule(G4double maxTime);
+    void SetAcceptanceTarget(const G4ThreeVector& target) { fTarget = target; fTargetSet = true; }
+    void ClearRules();
+
+    // Worker: aim the acceptance cone at the DUT box, unless a target is set
+    void BeginOfRun();
+
+    // Worker: add the kills of the run to the totals
+    void EndOfRun();
+    // Master: print the totals and reset them
+    static void PrintKills();
+
+  private:
+    enum RuleType { kMinEkin, kAcceptance, kMaxTime };
+
+    struct Rule {
+      RuleType    fType;
+      G4String    fParticle;                    ///< "all" for any particle
+      G4String    fRegion;                      ///< "all" for any region
+      G4double    fValue;                       ///< threshold, cos(half angle) or time
+      const G4ParticleDefinition* fParticleDef = nullptr;
+      const G4Region*             fRegionPtr = nullptr;
+      G4long      fNofKilled = 0;
+      G4double    fEkinKilled = 0.;
+
+      G4String Describe() const;
+    };
+
+    G4bool Kills(Rule& rule, const G4Track* track) const;
+    void   ResolveRules();
+
+    StackingMessenger* fMessenger;
+    std::vector<Rule>  fRules;
+    G4bool             fResolved;   // particle and region pointers found
+    G4ThreeVector      fTarget;
+    G4bool             fTargetSet;  // by /btf/stack/target
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
+
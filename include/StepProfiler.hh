@@ -0,0 +1,94 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StepProfiler.hh
+/// \brief Definition of the StepProfiler class
+
+#ifndef StepProfiler_h
+#define StepProfiler_h 1
+
+#include "globals.hh"
+#include "ChannelIndex.hh"
+
+#include <chrono>
+#include <vector>
+
+class G4Step;
+class G4Event;
+class G4LogicalVolume;
+class ProfilerMessenger;
+
+/// Steps, tracks and wall time per logical volume, particle and process
+///
+/// One instance per thread, fed by the SteppingAction when enabled with
+/// /btf/profile/enable. The time between two steps is given to the second
+/// one, in the volume of its pre-step point and for the process limiting
+/// it, so that it includes the tracking overhead of new tracks; the time
+/// between the events goes to a separate event overhead entry.
+///
+/// The counts are kept in flat tables indexed by the logical volume
+/// instance ID and by a dense channel ID for each (particle, process) pair
+/// met by the thread. EndOfRun() adds them, by name, to the totals shared
+/// by the threads, which the master prints sorted by time with PrintReport().
+
+class StepProfiler
+{
+  public:
+    StepProfiler();
+   ~StepProfiler();
+
+    void   SetEnabled(G4bool value) { fEnabled = value; }
+    G4bool IsEnabled() const        { return fEnabled; }
+    static void SetNofReportRows(G4int nofRows);
+
+    void Step(const G4Step* step);
+
+    // Worker: add the tables of the run to the totals
+    void EndOfRun();
+    // Master: print the totals and reset them
+    static void PrintReport();
+
+  private:
+    struct Cell {
+      G4long   fNofSteps = 0;
+      G4long   fNofTracks = 0;
+      G4double fTime = 0.;      ///< seconds
+    };
+
+    ProfilerMessenger* fMessenger;
+    G4bool             fEnabled;
+    std::vector<std::vector<Cell>> fCells;   // [volume ID][channel ID]
+    std::vector<const G4LogicalVolume*> fVolumes;
+    ChannelIndex       fChannels;
+    const G4Event*     fLastEvent;
+    G4double           fEventOverhead;
+    std::chrono::steady_clock::time_point fLastTime;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
+
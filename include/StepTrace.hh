@@ -0,0 +1,58 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StepTrace.hh
+/// \brief Record layout of the binary step-trace files
+
+#ifndef StepTrace_h
+#define StepTrace_h 1
+
+#include <cstdint>
+
+/// One step, written by StepTracer. Lengths in mm, energies in MeV
+/// (Geant4 internal units). The volume is the logical volume instance ID
+/// and the process a per-thread ID; their names are in the text file
+/// "<shard>.names" written next to each shard ("volume <id> <name>" and
+/// "process <id> <name>" lines).
+
+struct StepTraceRecord
+{
+  std::int32_t event;       ///< event ID
+  std::int32_t track;       ///< track ID
+  std::int32_t parent;      ///< parent track ID (0: primary)
+  std::int32_t pdg;         ///< PDG encoding
+  std::int32_t step;        ///< step number in the track
+  std::int16_t volume;      ///< volume of the pre-step point
+  std::int16_t process;     ///< process defining the step (-1: none)
+  float x, y, z;            ///< global post-step position
+  float ekin;               ///< post-step kinetic energy
+  float edep;               ///< energy deposited in the step
+};
+
+const char          kStepTraceMagic[]  = "BTFTRACE";
+const std::uint32_t kStepTraceVersion  = 1;
+
+#endif
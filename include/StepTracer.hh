@@ -0,0 +1,87 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StepTracer.hh
+/// \brief Definition of the StepTracer class
+
+#ifndef StepTracer_h
+#define StepTracer_h 1
+
+#include "globals.hh"
+
+#include "StepTrace.hh"
+
+#include <fstream>
+#include <vector>
+
+class G4Step;
+class G4LogicalVolume;
+class G4VProcess;
+class TraceMessenger;
+
+/// Binary step trace, an alternative to the text output of SteppingVerbose
+///
+/// One instance per thread, fed by the SteppingAction when a file is set
+/// with /btf/trace/file. Each step is a fixed-size StepTraceRecord kept in a
+/// buffer and written in blocks to the file of the thread (BinaryIO.hh), so
+/// that it can be memory-mapped and filtered offline with readtrace.
+/// EndOfRun(), called by the RunAction, writes the rest of the buffer and
+/// the names of the volume and process IDs; the file is kept open for the
+/// next runs until another file is set.
+
+class StepTracer
+{
+  public:
+    StepTracer();
+   ~StepTracer();
+
+    // Empty name: no trace
+    void   SetFileName(const G4String& fileName);
+    G4bool IsEnabled() const { return ! fFileName.empty(); }
+
+    void Record(const G4Step* step);
+    void EndOfRun();
+
+  private:
+    void  Flush();
+    void  Close();
+    G4int ProcessID(const G4VProcess* process);
+
+    TraceMessenger*              fMessenger;
+    G4String                     fFileName;
+    std::ofstream                fFile;
+    G4String                     fThreadFileName;
+    std::vector<StepTraceRecord> fBuffer;
+    std::vector<const G4LogicalVolume*> fVolumes;   // [volume ID]
+    std::vector<const G4VProcess*>          fProcesses;
+    const G4VProcess*            fLastProcess;
+    G4int                        fLastProcessID;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
+
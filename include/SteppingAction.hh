@@ -37,6 +37,8 @@
 #define SteppingAction_h 1
 
 #include "G4UserSteppingAction.hh"
+#include "StepProfiler.hh"
+#include "StepTracer.hh"
 
 class EventAction;
 
@@ -49,9 +51,15 @@ class SteppingAction : public G4UserSteppingAction
    ~SteppingAction();
 
     virtual void UserSteppingAction(const G4Step*);
+
+    StepProfiler* GetProfiler() { return &fProfiler; }
+    StepTracer*   GetTracer()   { return &fTracer; }
+    G4bool IsNeeded() const { return fProfiler.IsEnabled() || fTracer.IsEnabled(); }
     
   private:
     EventAction* fEventAction;
+    StepProfiler fProfiler;   // opt-in, /btf/profile/enable
+    StepTracer   fTracer;     // opt-in, /btf/trace/file
 };
 
 #endif
@@ -0,0 +1,65 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SubEventInformation.hh
+/// \brief Definition of the SubEventInformation class
+
+#ifndef SubEventInformation_h
+#define SubEventInformation_h 1
+
+#include "G4VUserEventInformation.hh"
+#include "globals.hh"
+
+/// Event information attached by the PrimaryGeneratorAction when a bunch is
+/// split into sub-events (/btf/gun/setSubEvents): G4 event e carries the
+/// sub-event e % n of the bunch e / n.
+
+class SubEventInformation : public G4VUserEventInformation
+{
+  public:
+    SubEventInformation(G4int bunchID, G4int subEvent, G4int nofSubEvents)
+      : G4VUserEventInformation(),
+        fBunchID(bunchID), fSubEvent(subEvent), fNofSubEvents(nofSubEvents) {}
+    virtual ~SubEventInformation() {}
+
+    virtual void Print() const
+    {
+      G4cout << "Sub-event " << fSubEvent << "/" << fNofSubEvents
+             << " of bunch " << fBunchID << G4endl;
+    }
+
+    G4int GetBunchID() const     { return fBunchID; }
+    G4int GetSubEvent() const    { return fSubEvent; }
+    G4int GetNofSubEvents() const { return fNofSubEvents; }
+
+  private:
+    G4int fBunchID;
+    G4int fSubEvent;
+    G4int fNofSubEvents;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -30,30 +30,40 @@
 #define TrackingAction_h 1
 
 #include "G4UserTrackingAction.hh"
-#include <map>
+#include "globals.hh"
+#include "ChannelIndex.hh"
 
-class G4Region;
-class G4ParticleDefinition;
-class DetectorConstruction;
+#include <vector>
+
+class G4LogicalVolume;
+
+/// Secondary census
+///
+/// Counts the secondaries by particle, creation volume and creator process.
+/// The volume comes from the touchable the track starts with (the logical
+/// volume instance ID) and the (particle, process) pair from a dense channel
+/// ID given the first time the thread meets it, so each track costs two
+/// array increments. EndOfRun() adds the counts, by name, to the totals
+/// shared by the threads and the master prints them with PrintCensus():
+/// per particle, per volume and per process, then the most frequent
+/// (particle, volume, process) combinations.
 
 class TrackingAction : public G4UserTrackingAction{
     public:
-    TrackingAction(DetectorConstruction* detector = 0);
+    TrackingAction();
     ~TrackingAction();
 
     virtual void PreUserTrackingAction(const G4Track*);
 
-    void SetDetector(DetectorConstruction* detector){ fDetector = detector;}
-    
-    std::map<const G4ParticleDefinition*, int>& GetNParticlesCreatedInTarget(){ return fNParticleInTarget; }
-
-    std::map<const G4ParticleDefinition*, int>& GetNParticlesCreatedInWorld(){ return fNParticleInWorld; }
+    // Worker: add the counts of the run to the totals
+    void EndOfRun();
+    // Master: print the totals and reset them
+    static void PrintCensus();
 
 private:
-    DetectorConstruction* fDetector;
-    G4Region* fTargetRegion;
-    std::map<const G4ParticleDefinition*, int> fNParticleInTarget;
-    std::map<const G4ParticleDefinition*, int> fNParticleInWorld;
+    std::vector<std::vector<G4long>> fCounts;   // [volume ID][channel ID]
+    std::vector<const G4LogicalVolume*> fVolumes;
+    ChannelIndex fChannels;
 };
 
 
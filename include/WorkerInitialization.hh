@@ -0,0 +1,77 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file WorkerInitialization.hh
+/// \brief Definition of the WorkerInitialization class
+
+#ifndef WorkerInitialization_h
+#define WorkerInitialization_h 1
+
+#include "G4UserWorkerInitialization.hh"
+#include "globals.hh"
+
+#include <vector>
+
+/// Placement of the worker threads on the cores
+///
+/// AvailableCores() is the number of cores the process may run on (its
+/// affinity mask, so that taskset, cpusets and batch systems are honoured),
+/// used as the default size of the worker pool. With a pinning mode, each
+/// worker binds itself when it starts, before building its geometry and
+/// physics, so that its memory is allocated on its node:
+///   core  worker i on the i-th available core (modulo their number)
+///   numa  worker i on all the available cores of NUMA node i % nofNodes
+/// The pinning is done by the thread itself, so it works the same with the
+/// task-based and the classic MT run managers. Without the Linux affinity
+/// calls the workers are left unpinned.
+
+class WorkerInitialization : public G4UserWorkerInitialization
+{
+  public:
+    enum Pinning { kNoPinning, kCorePinning, kNumaPinning };
+
+    WorkerInitialization(Pinning pinning);
+    virtual ~WorkerInitialization();
+
+    virtual void WorkerStart() const;
+
+    static G4int AvailableCores();
+    // Pinning mode from its name (none, core, numa); false if unknown
+    static G4bool ParsePinning(const G4String& name, Pinning& pinning);
+
+  private:
+    // CPU IDs of the affinity mask of the process, and per NUMA node
+    static std::vector<G4int> AvailableCpus();
+    static std::vector<std::vector<G4int>> NumaNodes(const std::vector<G4int>& cpus);
+
+    Pinning fPinning;
+    std::vector<G4int> fCpus;
+    std::vector<std::vector<G4int>> fNodes;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
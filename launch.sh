@@ -0,0 +1,128 @@
+#!/bin/bash
+#
+# Split a job over local TestEm4 processes: each process gets its own random
+# stream and a slice of the event range, the failed slices are run again and
+# the outputs are merged with hadd, pairwise and in parallel.
+#
+# Usage: ./launch.sh setup.mac nEvents nProcesses [output]
+#   run from the build directory; setup.mac is the job without /run/beamOn
+#   (geometry, /run/initialize, beam). Each process runs with
+#   LAUNCH_THREADS threads (1 by default) and the seed LAUNCH_SEED
+#   (12345 by default), and a slice
+#   is run at most LAUNCH_RETRIES more times (2 by default). With
+#   /btf/gun/setSubEvents n, set LAUNCH_UNIT=n so that the slices are
+#   made of whole bunches (nEvents must then be a multiple of n). The result
+#   is <output>.root (job.root by default). The file of
+#   /btf/det/recordPhaseSpace, /btf/output/asyncFile and
+#   /btf/overlay/buildLibrary in setup.mac gets the suffix _p<i> in process
+#   i (these files are not merged); macros called from setup.mac are not
+#   rewritten and must not use these commands.
+#
+if [ $# -lt 3 ]; then
+  echo "Usage: $0 setup.mac nEvents nProcesses [output]"
+  exit 2
+fi
+setup=$1
+nEvents=$2
+nProcs=$3
+output=${4:-job}
+threads=${LAUNCH_THREADS:-1}
+seed=${LAUNCH_SEED:-12345}
+retries=${LAUNCH_RETRIES:-2}
+unit=${LAUNCH_UNIT:-1}
+
+if grep -q "^ */run/beamOn" $setup; then
+  echo "$setup must not contain /run/beamOn, the events are given by $0"
+  exit 2
+fi
+command -v hadd > /dev/null || { echo "hadd not found, set up ROOT first"; exit 2; }
+if [ $((nEvents % unit)) -ne 0 ]; then
+  echo "nEvents=$nEvents is not a multiple of LAUNCH_UNIT=$unit (whole bunches only)"
+  exit 2
+fi
+
+# Commands writing a file of their own: one file per process, or all the
+# processes would write the same <file>.t0
+fileCommands="/btf/(det/recordPhaseSpace|output/asyncFile|overlay/buildLibrary)"
+
+# Slices of the event range, in units of whole bunches: process i gets the
+# events first[i] ... first[i]+events[i]-1. The event IDs are those of a
+# single process and each event is seeded from (run seed, event ID), so
+# the processes draw from non-overlapping streams of the MixMax engine and
+# the events are those of the job run in one process.
+nUnits=$((nEvents/unit))
+first=()
+events=()
+start=0
+for ((i=0; i<nProcs; i++)); do
+  n=$((nUnits/nProcs + (i < nUnits%nProcs ? 1 : 0)))
+  first[$i]=$((start*unit))
+  events[$i]=$((n*unit))
+  start=$((start+n))
+done
+
+runSlice() {
+  local i=$1
+  sed -E "s#^( *$fileCommands +)([^ ]+)#\1\3_p$i#" $setup > ${output}_p$i.setup.mac
+  {
+    echo "/control/execute ${output}_p$i.setup.mac"
+    echo "/random/setSeeds $seed"
+    echo "/btf/gun/firstEvent ${first[$i]}"
+    echo "/analysis/setFileName ${output}_p$i.root"
+    echo "/run/beamOn ${events[$i]}"
+  } > ${output}_p$i.mac
+  rm -f ${output}_p$i.root
+  ./TestEm4 -t $threads -m ${output}_p$i.mac > ${output}_p$i.log 2>&1 && [ -s ${output}_p$i.root ]
+}
+
+# Run the slices, then again the failed ones
+pending=$(seq 0 $((nProcs-1)))
+for ((attempt=0; attempt<=retries; attempt++)); do
+  declare -A slicePids=()
+  for i in $pending; do
+    [ ${events[$i]} -eq 0 ] && continue
+    runSlice $i &
+    slicePids[$i]=$!
+  done
+  failed=""
+  for i in "${!slicePids[@]}"; do
+    wait ${slicePids[$i]} || failed="$failed $i"
+  done
+  unset slicePids
+  [ -z "$failed" ] && break
+  echo "slices failed (attempt $attempt):$failed, see ${output}_p<i>.log"
+  pending=$failed
+done
+if [ -n "$failed" ]; then
+  echo "giving up after $retries retries"
+  exit 1
+fi
+echo "$nProcs processes: events ${first[0]} ... $((start*unit-1)) done"
+grep -Eq "^ *$fileCommands +[^ ]" $setup && echo "per-process files of $setup: <file>_p<i>"
+
+# Tree reduction: merge the files two by two, all the pairs of a level at
+# the same time, until one file is left
+files=()
+for ((i=0; i<nProcs; i++)); do
+  [ ${events[$i]} -gt 0 ] && files+=(${output}_p$i.root)
+done
+level=0
+while [ ${#files[@]} -gt 1 ]; do
+  merged=()
+  pids=()
+  for ((k=0; k+1<${#files[@]}; k+=2)); do
+    out=${output}_m${level}_$((k/2)).root
+    hadd -f $out ${files[$k]} ${files[$((k+1))]} > /dev/null &
+    pids+=($!)
+    merged+=($out)
+  done
+  for pid in "${pids[@]}"; do
+    wait $pid || { echo "hadd failed at level $level"; exit 1; }
+  done
+  [ $((${#files[@]} % 2)) -eq 1 ] && merged+=(${files[-1]})
+  files=(${merged[@]})
+  level=$((level+1))
+done
+mv ${files[0]} $output.root
+rm -f ${output}_p*.root ${output}_m*.root ${output}_p*.mac
+echo "merged into $output.root"
@@ -0,0 +1,32 @@
+#!/bin/bash
+#
+# Compare the physics lists of TestEm4: initialization time, throughput and
+# shift of the main observables relative to FTFP_BERT.
+#
+# Usage: ./physbench.sh [nThreads] [lists...]
+#   run from the build directory; each list writes physbench_<list>.root
+#   and physbench_<list>.log, then physbench.C prints the comparison.
+#
+threads=${1:-16}
+shift
+lists=${@:-"emstandard emstandard_opt3 emstandard_opt4 emlivermore"}
+
+for list in FTFP_BERT $lists; do
+  echo "=== $list"
+  ./TestEm4 -p $list -t $threads -m physbench.mac > physbench_$list.log 2>&1 || {
+    echo "TestEm4 failed, see physbench_$list.log"
+    exit 1
+  }
+  mv dutOut.root physbench_$list.root
+done
+
+echo
+printf "%-18s %12s %12s\n" "list" "init [s]" "events/s"
+for list in FTFP_BERT $lists; do
+  init=$(grep -- "---> Initialization time:" physbench_$list.log | awk '{print $4}')
+  rate=$(grep -- "---> Run 0:" physbench_$list.log | tail -1 | awk '{print $9}')
+  printf "%-18s %12s %12s\n" $list "$init" "$rate"
+done
+
+echo
+root -l -b -q "physbench.C(\"$lists\")"
@@ -0,0 +1,19 @@
+#!/bin/bash
+#
+# Physics equivalence gate: compare the output of a run using a speed-up
+# (virtual layers, fast air, tuned cuts, track killing...) with the output of
+# the full simulation of the same beam.
+#
+# Usage: ./physcompare.sh reference.root test.root [alpha]
+#   physcompare.C tests all the histograms and the RUN/AUX distributions
+#   (or the DUTEvents columns); the exit code is 1 if any of them differs
+#   at the significance level alpha (0.01 by default) or is missing from a
+#   file, 2 if a file cannot be read.
+#
+if [ $# -lt 2 ]; then
+  echo "Usage: $0 reference.root test.root [alpha]"
+  exit 2
+fi
+alpha=${3:-0.01}
+
+root -l -b -q "physcompare.C(\"$1\", \"$2\", $alpha)"
@@ -0,0 +1,201 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file readtrace.cc
+/// \brief Offline reader of the binary step traces (/btf/trace/file)
+//
+// Usage: readtrace [-e event] [-t track] [-p pdg] [-v volume] [-r process]
+//                  [-m minEdep(MeV)] [-n maxRecords] [-c] file...
+//
+// Each file (a shard "<base>.t<N>" or the sequential "<base>") is memory
+// mapped; the records passing all the filters are printed one per line, or
+// only counted with -c. Volume and process filters are names (substring
+// match) resolved with the "<file>.names" file of the shard.
+
+#include "StepTrace.hh"
+#include "BinaryIO.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  struct Filter {
+    long        event = -1;
+    long        track = -1;
+    long        pdg = 0;
+    std::string volume;
+    std::string process;
+    double      minEdep = -1.;
+    long        maxRecords = -1;
+    bool        countOnly = false;
+  };
+
+  void PrintUsage()
+  {
+    std::fprintf(stderr, "Usage: readtrace [-e event] [-t track] [-p pdg] [-v volume] [-r process]\n"
+                         "                 [-m minEdep(MeV)] [-n maxRecords] [-c] file...\n");
+  }
+
+  // "volume <id> <name>" and "process <id> <name>" lines
+  void ReadNames(const std::string& fileName, std::map<int, std::string>& volumes,
+                 std::map<int, std::string>& processes)
+  {
+    std::ifstream in(fileName + ".names");
+    std::string kind;
+    int id;
+    std::string name;
+    while ( in >> kind >> id && std::getline(in >> std::ws, name) ) {
+      if ( kind == "volume" ) volumes[id] = name;
+      else if ( kind == "process" ) processes[id] = name;
+    }
+  }
+
+  const char* Name(const std::map<int, std::string>& names, int id)
+  {
+    auto it = names.find(id);
+    return it != names.end() ? it->second.c_str() : "?";
+  }
+
+  // Number of records printed (or counted), -1 on error
+  long ReadFile(const std::string& fileName, const Filter& filter, long maxRecords)
+  {
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if ( fd < 0 ) {
+      std::fprintf(stderr, "readtrace: cannot open %s\n", fileName.c_str());
+      return -1;
+    }
+    struct stat status;
+    fstat(fd, &status);
+    std::size_t size = status.st_size;
+    if ( size < sizeof(BinaryFileHeader) ) {
+      std::fprintf(stderr, "readtrace: %s is too short\n", fileName.c_str());
+      close(fd);
+      return -1;
+    }
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if ( data == MAP_FAILED ) {
+      std::fprintf(stderr, "readtrace: cannot map %s\n", fileName.c_str());
+      return -1;
+    }
+
+    auto header = static_cast<const BinaryFileHeader*>(data);
+    if ( std::strncmp(header->magic, kStepTraceMagic, sizeof(header->magic)) != 0
+         || header->version != kStepTraceVersion || header->recordSize != sizeof(StepTraceRecord) ) {
+      std::fprintf(stderr, "readtrace: %s is not a %s v%u file\n", fileName.c_str(),
+                   kStepTraceMagic, kStepTraceVersion);
+      munmap(data, size);
+      return -1;
+    }
+    auto records = reinterpret_cast<const StepTraceRecord*>(static_cast<const char*>(data) + sizeof(BinaryFileHeader));
+    std::size_t nofRecords = (size - sizeof(BinaryFileHeader)) / sizeof(StepTraceRecord);
+
+    // Name filters as sets of IDs
+    std::map<int, std::string> volumes, processes;
+    ReadNames(fileName, volumes, processes);
+    std::vector<bool> volumeOK(1 << 15, filter.volume.empty());
+    std::vector<bool> processOK(1 << 15, filter.process.empty());
+    for ( const auto& volume : volumes ) {
+      if ( ! filter.volume.empty() && volume.second.find(filter.volume) != std::string::npos ) volumeOK[volume.first] = true;
+    }
+    for ( const auto& process : processes ) {
+      if ( ! filter.process.empty() && process.second.find(filter.process) != std::string::npos ) processOK[process.first] = true;
+    }
+
+    long nofSelected = 0;
+    for ( std::size_t i = 0; i < nofRecords; ++i ) {
+      if ( maxRecords >= 0 && nofSelected >= maxRecords ) break;
+      const auto& r = records[i];
+      if ( filter.event >= 0 && r.event != filter.event ) continue;
+      if ( filter.track >= 0 && r.track != filter.track ) continue;
+      if ( filter.pdg != 0 && r.pdg != filter.pdg ) continue;
+      if ( r.volume < 0 || ! volumeOK[r.volume] ) continue;
+      if ( r.process < 0 ? ! filter.process.empty() : ! processOK[r.process] ) continue;
+      if ( r.edep < filter.minEdep ) continue;
+      ++nofSelected;
+      if ( filter.countOnly ) continue;
+      std::printf("%8d %6d %6d %6d %5d %10.4f %10.4f %10.4f %12.6g %12.6g  %-32s %s\n",
+                  r.event, r.track, r.parent, r.pdg, r.step, r.x, r.y, r.z, r.ekin, r.edep,
+                  Name(volumes, r.volume), r.process < 0 ? "none" : Name(processes, r.process));
+    }
+    munmap(data, size);
+    return nofSelected;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  Filter filter;
+  std::vector<std::string> files;
+  for ( int i = 1; i < argc; ++i ) {
+    std::string arg = argv[i];
+    bool hasValue = i+1 < argc;
+    if      ( arg == "-e" && hasValue ) filter.event = std::atol(argv[++i]);
+    else if ( arg == "-t" && hasValue ) filter.track = std::atol(argv[++i]);
+    else if ( arg == "-p" && hasValue ) filter.pdg = std::atol(argv[++i]);
+    else if ( arg == "-v" && hasValue ) filter.volume = argv[++i];
+    else if ( arg == "-r" && hasValue ) filter.process = argv[++i];
+    else if ( arg == "-m" && hasValue ) filter.minEdep = std::atof(argv[++i]);
+    else if ( arg == "-n" && hasValue ) filter.maxRecords = std::atol(argv[++i]);
+    else if ( arg == "-c" ) filter.countOnly = true;
+    else if ( arg[0] == '-' ) {
+      PrintUsage();
+      return 1;
+    }
+    else files.push_back(arg);
+  }
+  if ( files.empty() ) {
+    PrintUsage();
+    return 1;
+  }
+
+  if ( ! filter.countOnly ) {
+    std::printf("%8s %6s %6s %6s %5s %10s %10s %10s %12s %12s  %-32s %s\n",
+                "event", "track", "parent", "pdg", "step", "x [mm]", "y [mm]", "z [mm]",
+                "ekin [MeV]", "edep [MeV]", "volume", "process");
+  }
+  long total = 0;
+  for ( const auto& file : files ) {
+    long left = filter.maxRecords >= 0 ? filter.maxRecords - total : -1;
+    auto nofSelected = ReadFile(file, filter, left);
+    if ( nofSelected < 0 ) return 1;
+    total += nofSelected;
+  }
+  if ( filter.countOnly ) std::printf("%ld\n", total);
+  return 0;
+}
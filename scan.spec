@@ -0,0 +1,18 @@
+#
+# Example of scan specification for /btf/scan/run (see ScanEngine.hh):
+# beam energy and transverse position of the DUT box, in one process.
+#   ./TestEm4 -m scan.mac
+#
+events 2000
+output scan
+#
+param energy  /gps/energy {} MeV
+param dutX    /btf/det/dutPosition {} 0 mm
+#
+#     label        energy  dutX
+point e450_x0      450     0
+point e450_x2      450     2
+point e450_x5      450     5
+point e300_x0      300     0
+point e300_x2      300     2
+point e300_x5      300     5
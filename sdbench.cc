@@ -0,0 +1,163 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file sdbench.cc
+/// \brief Micro-benchmark of the scoring kernels (SensorKernels.hh)
+//
+// Usage: sdbench [nSteps] [stepsPerEvent...]
+//
+// Synthetic steps (electrons crossing the sensors at small angles, a few
+// layers per step) are generated once and fed to the kernels of DUTSD,
+// FitpixSD and of the EventAction end of event, without a Geant4 run.
+// For each hit density (steps per event, 1 10 100 1000 10000 by default)
+// the time per step of ProcessHits and the time per event of the end of
+// event (hit store to record and ntuple columns, and clearing the store)
+// are printed for:
+//   DUT       sapphire 110 um, 110 layer volumes, pads
+//   DUTvirt   same with virtual layers (/btf/det/setVirtualLayers)
+//   Fitpix    silicon 300 um, 100 layer volumes
+//   FitpixVirt same with virtual layers
+
+#include "SensorKernels.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+  struct Sensor {
+    const char* name;
+    G4int       nofLayers;
+    G4double    thickness;
+    G4bool      virtualLayers;
+    G4bool      withPads;
+  };
+
+  // Steps of one sensor: random entry points around the beam axis (and the
+  // pads), lengths of up to a few layers along a direction close to -z
+  std::vector<SensorStep> MakeSteps(const Sensor& sensor, std::size_t nSteps, std::mt19937_64& engine)
+  {
+    std::normal_distribution<G4double> beam(0., 8*mm);
+    std::normal_distribution<G4double> angle(0., 0.05);
+    std::uniform_real_distribution<G4double> uniform(0., 1.);
+    std::exponential_distribution<G4double> edep(1./(0.5*keV));
+    auto layerThickness = sensor.thickness/sensor.nofLayers;
+    // the sensor centre in the global frame
+    G4ThreeVector centre(0., 0., -10*cm);
+
+    std::vector<SensorStep> steps(nSteps);
+    for ( auto& step : steps ) {
+      G4ThreeVector localPre(beam(engine), 2.5*beam(engine),
+                             (uniform(engine) - 0.5)*sensor.thickness);
+      G4ThreeVector direction(angle(engine), angle(engine), -1.);
+      auto length = 3*layerThickness*uniform(engine);
+      auto localPost = localPre + length*direction.unit();
+      if ( localPost.z() < -sensor.thickness/2 ) localPost.setZ(-sensor.thickness/2);
+      step.fEdep = edep(engine);
+      step.fStepLength = (localPost - localPre).mag();
+      step.fLocalPre = localPre;
+      step.fLocalPost = localPost;
+      step.fPrePos = localPre + centre;
+      step.fPostPos = localPost + centre;
+      // the layer volume of the pre-step point (copy number)
+      auto layer = G4int((sensor.thickness/2 - localPre.z())/layerThickness);
+      step.fLayer = std::min(std::max(layer, 0), sensor.nofLayers-1);
+    }
+    return steps;
+  }
+
+  void Run(const Sensor& sensor, const std::vector<SensorStep>& steps, std::size_t stepsPerEvent)
+  {
+    using Clock = std::chrono::steady_clock;
+    HitStore store(sensor.nofLayers);
+    LayerSlicer slicer(sensor.nofLayers, sensor.virtualLayers ? sensor.thickness : 0.);
+    SensorRecord record;
+    std::vector<G4double> edep, xpos, ypos, zpos;
+
+    auto nofEvents = steps.size()/stepsPerEvent;
+    std::chrono::duration<double, std::nano> stepTime(0.), eventTime(0.);
+    G4double sum = 0.;
+    std::size_t nofDeposits = 0;
+    auto step = steps.begin();
+    for ( std::size_t event = 0; event < nofEvents; ++event ) {
+      auto start = Clock::now();
+      for ( std::size_t i = 0; i < stepsPerEvent; ++i, ++step ) {
+        SensorKernels::AddLayers(store, slicer, *step);
+        if ( sensor.withPads ) SensorKernels::AddPads(store, *step);
+      }
+      auto middle = Clock::now();
+      SensorKernels::FillSensorRecord(store, record, sensor.withPads);
+      SensorKernels::FillLayerColumns(record, edep, xpos, ypos, zpos);
+      store.Clear();
+      auto end = Clock::now();
+      stepTime += middle - start;
+      eventTime += end - middle;
+      // keep the results alive
+      sum += record.fEdep + record.fEdepSmall;
+      nofDeposits += record.fLayers.size();
+    }
+
+    auto nofSteps = nofEvents*stepsPerEvent;
+    std::printf("%-11s %10zu %10zu %12.1f %14.1f %14.1f %12.1f\n",
+                sensor.name, stepsPerEvent, nofEvents,
+                stepTime.count()/nofSteps, stepTime.count()/nofEvents,
+                eventTime.count()/nofEvents, G4double(nofDeposits)/nofEvents);
+    if ( sum < 0. ) std::printf("%g\n", sum);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t nSteps = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+  std::vector<std::size_t> densities;
+  for ( int i = 2; i < argc; ++i ) densities.push_back(std::strtoul(argv[i], nullptr, 10));
+  if ( densities.empty() ) densities = {1, 10, 100, 1000, 10000};
+
+  const Sensor sensors[] = {
+    { "DUT",        110, 110*um, false, true  },
+    { "DUTvirt",    110, 110*um, true,  true  },
+    { "Fitpix",     100, 300*um, false, false },
+    { "FitpixVirt", 100, 300*um, true,  false }
+  };
+
+  std::printf("%-11s %10s %10s %12s %14s %14s %12s\n", "sensor", "steps/evt", "events",
+              "ns/step", "ns/evt steps", "ns/evt end", "layers/evt");
+  for ( const auto& sensor : sensors ) {
+    // fixed seed: the same steps for all the builds being compared
+    std::mt19937_64 engine(12345);
+    auto steps = MakeSteps(sensor, nSteps, engine);
+    for ( auto density : densities ) {
+      if ( density == 0 || density > nSteps ) continue;
+      Run(sensor, steps, density);
+    }
+  }
+  return 0;
+}
@@ -33,7 +33,9 @@
 #include "EventAction.hh"
 #include "DetectorConstruction.hh"
 #include "TrackingAction.hh"
-//#include "SteppingAction.hh"
+#include "StackingAction.hh"
+#include "OverlayEngine.hh"
+#include "SteppingAction.hh"
 //#include "SteppingVerbose.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -65,13 +67,25 @@ void ActionInitialization::BuildForMaster() const
 
 void ActionInitialization::Build() const
 {
-  SetUserAction(new RunAction);
-  SetUserAction(new PrimaryGeneratorAction);
-  EventAction* eventAction = new EventAction;
+  RunAction* runAction = new RunAction;
+  SetUserAction(runAction);
+  // The overlay engine is shared by the generator, drawing the entries, and
+  // the event action, adding them up (and owning it)
+  OverlayEngine* overlay = new OverlayEngine;
+  SetUserAction(new PrimaryGeneratorAction(overlay));
+  EventAction* eventAction = new EventAction(runAction, overlay);
   SetUserAction(eventAction);
-  //SetUserAction(new SteppingAction(eventAction));
-  //TrackingAction* trackingAction = new TrackingAction(fDetectorConstruction);
-  //SetUserAction(trackingAction);
+  StackingAction* stackingAction = new StackingAction;
+  SetUserAction(stackingAction);
+  runAction->SetStackingAction(stackingAction);
+  SteppingAction* steppingAction = new SteppingAction(eventAction);
+  SetUserAction(steppingAction);
+  runAction->SetSteppingAction(steppingAction);
+  runAction->SetStepProfiler(steppingAction->GetProfiler());
+  runAction->SetStepTracer(steppingAction->GetTracer());
+  TrackingAction* trackingAction = new TrackingAction;
+  SetUserAction(trackingAction);
+  runAction->SetTrackingAction(trackingAction);
 }  
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
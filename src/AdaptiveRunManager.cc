@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file AdaptiveRunManager.cc
+/// \brief Implementation of the AdaptiveRunManager class
+
+#include "AdaptiveRunManager.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Threading.hh"
+
+namespace {
+  // the chunk size and the events dealt by G4MTRunManager go together
+  G4Mutex chunkMutex = G4MUTEX_INITIALIZER;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AdaptiveRunManager::AdaptiveRunManager()
+ : G4MTRunManager()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AdaptiveRunManager::~AdaptiveRunManager()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AdaptiveRunManager::InitializeEventLoop(G4int nofEvents, const char* macroFile,
+                                             G4int nofSelect)
+{
+  G4MTRunManager::InitializeEventLoop(nofEvents, macroFile, nofSelect);
+  fScheduler.Reset();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int AdaptiveRunManager::SetUpNEvents(G4Event* event, G4SeedsQueue* seedsQueue,
+                                       G4bool reseedRequired)
+{
+  G4AutoLock lock(&chunkMutex);
+  auto nofRemaining = numberOfEventToBeProcessed - numberOfEventProcessed;
+  if ( nofRemaining > 0 && eventModuloDef == 0 ) {
+    eventModulo = fScheduler.NextChunk(G4Threading::G4GetThreadId(), nofRemaining,
+                                       GetNumberOfThreads());
+  }
+  return G4MTRunManager::SetUpNEvents(event, seedsQueue, reseedRequired);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AdaptiveRunManager::RunTermination()
+{
+  G4MTRunManager::RunTermination();
+  fScheduler.Print();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
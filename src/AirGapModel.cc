@@ -0,0 +1,170 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file AirGapModel.cc
+/// \brief Implementation of the AirGapModel class
+
+#include "AirGapModel.hh"
+
+#include "G4FastTrack.hh"
+#include "G4FastStep.hh"
+#include "G4Track.hh"
+#include "G4Electron.hh"
+#include "G4Positron.hh"
+#include "G4Material.hh"
+#include "G4VSolid.hh"
+#include "G4LogicalVolume.hh"
+#include "Randomize.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+namespace {
+  // Margin kept between the exit point and the side faces of the envelope,
+  // in units of the rms lateral displacement
+  const G4double kLateralMargin = 5.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AirGapModel::AirGapModel(const G4String& name, G4Region* envelope, G4double minEkin)
+ : G4VFastSimulationModel(name, envelope),
+   fEnvelope(envelope),
+   fMinEkin(minEkin)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AirGapModel::~AirGapModel()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool AirGapModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return &particle == G4Electron::Definition() || &particle == G4Positron::Definition();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool AirGapModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  if ( fastTrack.GetPrimaryTrack()->GetKineticEnergy() < fMinEkin ) return false;
+
+  // The envelopes are boxes along the beam: the straight line must leave
+  // through the upstream or downstream face, far enough from the sides
+  // not to be pushed out of them by the scattering
+  const auto& pos = fastTrack.GetPrimaryTrackLocalPosition();
+  const auto& dir = fastTrack.GetPrimaryTrackLocalDirection();
+  if ( std::abs(dir.z()) < 0.5 ) return false;
+  auto solid = fastTrack.GetEnvelopeSolid();
+  G4double length = solid->DistanceToOut(pos, dir);
+  if ( length < 1.*mm ) return false;
+  auto exitPos = pos + length*dir;
+  auto extent = solid->GetExtent();
+  auto material = fastTrack.GetEnvelopeLogicalVolume()->GetMaterial();
+  G4double margin = kLateralMargin * length*HighlandAngle(fastTrack.GetPrimaryTrack(), length, material)/std::sqrt(3.);
+  return std::abs(exitPos.z()) > extent.GetZmax() - 1.*um
+      && exitPos.x() - margin > extent.GetXmin() && exitPos.x() + margin < extent.GetXmax()
+      && exitPos.y() - margin > extent.GetYmin() && exitPos.y() + margin < extent.GetYmax();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AirGapModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep)
+{
+  auto track = fastTrack.GetPrimaryTrack();
+  const auto& pos = fastTrack.GetPrimaryTrackLocalPosition();
+  const auto& dir = fastTrack.GetPrimaryTrackLocalDirection();
+  auto solid = fastTrack.GetEnvelopeSolid();
+  auto material = fastTrack.GetEnvelopeLogicalVolume()->GetMaterial();
+  auto particle = track->GetDefinition();
+  G4double length = solid->DistanceToOut(pos, dir);
+
+  // Mean energy loss, with the dE/dx at the mean energy of the gap
+  G4double ekin = track->GetKineticEnergy();
+  G4double dedx = fEmCalculator.GetDEDX(ekin, particle, material, fEnvelope);
+  G4double eloss = length * fEmCalculator.GetDEDX(std::max(ekin - 0.5*dedx*length, 0.5*ekin),
+                                                  particle, material, fEnvelope);
+  if ( eloss >= ekin ) {
+    fastStep.KillPrimaryTrack();
+    fastStep.ProposePrimaryTrackPathLength(length);
+    fastStep.ProposeTotalEnergyDeposited(ekin);
+    return;
+  }
+
+  // For each projection, the angle and the correlated lateral displacement
+  // (PDG, Passage of particles through matter)
+  G4double theta0 = HighlandAngle(track, length, material);
+  G4double theta[2], shift[2];
+  for ( G4int i = 0; i < 2; ++i ) {
+    G4double z1 = G4RandGauss::shoot();
+    G4double z2 = G4RandGauss::shoot();
+    shift[i] = length*theta0*(z1/std::sqrt(12.) + z2/2.);
+    theta[i] = z2*theta0;
+  }
+
+  // Frame of the incoming direction
+  auto u = dir.orthogonal().unit();
+  auto v = dir.cross(u);
+  auto newDir = (dir + std::tan(theta[0])*u + std::tan(theta[1])*v).unit();
+
+  // Exit point on the same face, moved by the displacement (kept inside
+  // the face for the tails beyond the trigger margin)
+  auto extent = solid->GetExtent();
+  auto exitPos = pos + length*dir + shift[0]*u + shift[1]*v;
+  exitPos.setX(std::min(std::max(exitPos.x(), extent.GetXmin()), extent.GetXmax()));
+  exitPos.setY(std::min(std::max(exitPos.y(), extent.GetYmin()), extent.GetYmax()));
+  exitPos.setZ(pos.z() + length*dir.z());
+  // Leaving through the face, not back into the envelope
+  if ( newDir.z()*dir.z() <= 0. ) newDir = dir;
+
+  G4double mass = particle->GetPDGMass();
+  G4double momentum = track->GetMomentum().mag();
+  G4double beta = momentum / (ekin + mass);
+  fastStep.ProposePrimaryTrackFinalPosition(exitPos);
+  fastStep.ProposePrimaryTrackFinalKineticEnergyAndDirection(ekin - eloss, newDir);
+  fastStep.ProposePrimaryTrackFinalTime(track->GetGlobalTime() + length/(beta*c_light));
+  fastStep.ProposePrimaryTrackFinalProperTime(track->GetProperTime()
+                                              + length*mass/(momentum*c_light));
+  fastStep.ProposePrimaryTrackPathLength(length);
+  fastStep.ProposeTotalEnergyDeposited(eloss);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double AirGapModel::HighlandAngle(const G4Track* track, G4double length,
+                                    const G4Material* material) const
+{
+  // Width of the projected angle distribution
+  G4double momentum = track->GetMomentum().mag();
+  G4double beta = track->GetVelocity() / c_light;
+  G4double t = length / material->GetRadlen();
+  if ( t <= 0. ) return 0.;
+  return 13.6*MeV / (beta*momentum) * std::sqrt(t) * (1. + 0.038*std::log(t / (beta*beta)));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
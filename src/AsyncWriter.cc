@@ -0,0 +1,189 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file AsyncWriter.cc
+/// \brief Implementation of the AsyncWriter class
+
+#include "AsyncWriter.hh"
+#include "BinaryIO.hh"
+
+#include "G4AutoLock.hh"
+
+#include <chrono>
+
+namespace {
+  // events waiting in the queue of one worker
+  const std::size_t kQueueCapacity = 4096;
+  // rows written at once
+  const std::size_t kBatchSize = 1 << 16;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncWriter* AsyncWriter::Instance()
+{
+  static AsyncWriter instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncWriter::AsyncWriter()
+ : fActive(false),
+   fStopping(false),
+   fNofQueues(0),
+   fNofEvents(0),
+   fNofFullQueues(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncWriter::~AsyncWriter()
+{
+  fStopping.store(true, std::memory_order_release);
+  if ( fThread.joinable() ) fThread.join();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncWriter::Start(const G4String& fileName)
+{
+  Stop();
+
+  // A new file for the first run only, the next runs append to it
+  if ( ! fFile.is_open() || fileName != fFileName ) {
+    if ( fFile.is_open() ) fFile.close();
+    fFile.open(fileName, std::ios::binary | std::ios::trunc);
+    if ( ! fFile ) {
+      G4ExceptionDescription msg;
+      msg << "Cannot open asynchronous output file " << fileName; 
+      G4Exception("AsyncWriter::Start()",
+        "MyCode0018", FatalException, msg);
+      return;
+    }
+    WriteBinaryHeader(fFile, kOverlayMagic, kOverlayVersion, sizeof(OverlayRecord));
+    fFileName = fileName;
+  }
+  fBatch.reserve(kBatchSize);
+  fNofEvents = 0;
+  fNofFullQueues.store(0);
+  fStopping.store(false);
+  fThread = std::thread(&AsyncWriter::Run, this);
+  fActive.store(true, std::memory_order_release);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncWriter::Stop()
+{
+  if ( ! IsActive() ) return;
+
+  // Called once the workers are done: the writer drains the queues and exits
+  fStopping.store(true, std::memory_order_release);
+  fThread.join();
+  fFile.flush();
+  fActive.store(false, std::memory_order_release);
+
+  G4cout << "---> Asynchronous output: " << fNofEvents << " events written";
+  if ( fNofFullQueues > 0 ) {
+    G4cout << ", workers waited " << fNofFullQueues << " times for a full queue";
+  }
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncWriter::Push(const EventRecord& record)
+{
+  Rows rows;
+  OverlayEngine::AppendRows(record, rows);
+
+  // The writer is behind: wait for room rather than lose events
+  auto queue = GetThreadQueue();
+  if ( ! queue->TryPush(rows) ) {
+    ++fNofFullQueues;
+    do {
+      std::this_thread::yield();
+    } while ( ! queue->TryPush(rows) );
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncWriter::Queue* AsyncWriter::GetThreadQueue()
+{
+  static G4ThreadLocal Queue* queue = nullptr;
+  if ( ! queue ) {
+    G4AutoLock lock(&fQueuesMutex);
+    fQueues.push_back(std::make_unique<Queue>(kQueueCapacity));
+    queue = fQueues.back().get();
+    fNofQueues.store(fQueues.size(), std::memory_order_release);
+  }
+  return queue;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncWriter::Run()
+{
+  std::vector<Queue*> queues;
+  Rows rows;
+  while ( true ) {
+    // read the flag first: whatever was pushed before it was set is then
+    // found by the pass below
+    auto stopping = fStopping.load(std::memory_order_acquire);
+
+    if ( queues.size() != fNofQueues.load(std::memory_order_acquire) ) {
+      G4AutoLock lock(&fQueuesMutex);
+      queues.clear();
+      for ( const auto& queue : fQueues ) queues.push_back(queue.get());
+    }
+
+    G4bool idle = true;
+    for ( auto queue : queues ) {
+      while ( queue->TryPop(rows) ) {
+        idle = false;
+        ++fNofEvents;
+        fBatch.insert(fBatch.end(), rows.begin(), rows.end());
+        if ( fBatch.size() >= kBatchSize ) Flush();
+      }
+    }
+    if ( idle ) {
+      if ( stopping ) break;
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  }
+  Flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncWriter::Flush()
+{
+  fFile.write(reinterpret_cast<const char*>(fBatch.data()), fBatch.size()*sizeof(OverlayRecord));
+  fBatch.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -23,68 +23,63 @@
 // * acceptance of all terms of the Geant4 Software license.          *
 // ********************************************************************
 //
-//
-/// \file DUTHit.cc
-/// \brief Implementation of the DUTHit class
-
-#include "DUTHit.hh"
-#include "G4UnitsTable.hh"
-#include "G4VVisManager.hh"
-#include <iomanip>
-
-G4ThreadLocal G4Allocator<DUTHit>* DUTHitAllocator = 0;
-
-//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+/// \file BunchAssembler.cc
+/// \brief Implementation of the BunchAssembler class
 
-DUTHit::DUTHit()
- : G4VHit(),
-   fEdep(0.),
-   fTrackLength(0.),
-   fEdepPos(G4ThreeVector(0))
-{}
+#include "BunchAssembler.hh"
 
-//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-
-DUTHit::~DUTHit() {}
+#include "G4AutoLock.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-DUTHit::DUTHit(const DUTHit& right)
-  :G4VHit(){
-    fEdep        = right.fEdep;
-    fTrackLength = right.fTrackLength;
-    fEdepPos     = right.fEdepPos;
+BunchAssembler* BunchAssembler::Instance()
+{
+  static BunchAssembler instance;
+  return &instance;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-const DUTHit& DUTHit::operator=(const DUTHit& right)
+G4bool BunchAssembler::Add(EventRecord& record, G4int subEvent, G4int nofSubEvents)
 {
-  fEdep        = right.fEdep;
-  fTrackLength = right.fTrackLength;
-  fEdepPos     = right.fEdepPos;
-  return *this;
+  auto bunchID = record.fEventID;
+  auto primaryEnergy = record.fPrimaryEnergy;
+
+  G4AutoLock lock(&fMutex);
+  auto& pending = fPending[bunchID];
+  if ( pending.fNofAdded == 0 ) {
+    pending.fRecord = std::move(record);
+  }
+  else {
+    pending.fRecord.Add(record);
+  }
+  // The sub-events complete in any order: the primary of the bunch is the
+  // first one of sub-event 0, as in the unsplit event
+  if ( subEvent == 0 ) pending.fPrimaryEnergy = primaryEnergy;
+  if ( ++pending.fNofAdded < nofSubEvents ) return false;
+
+  record = std::move(pending.fRecord);
+  record.fPrimaryEnergy = pending.fPrimaryEnergy;
+  fPending.erase(bunchID);
+  return true;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-G4bool DUTHit::operator==(const DUTHit& right) const
+void BunchAssembler::Reset()
 {
-  return ( this == &right ) ? true : false;
+  G4AutoLock lock(&fMutex);
+  fPending.clear();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void DUTHit::Print()
+G4int BunchAssembler::DropIncomplete()
 {
-  G4cout
-     << "Edep: " 
-     << std::setw(7) << G4BestUnit(fEdep,"Energy")
-     << " track length: " 
-     << std::setw(7) << G4BestUnit(fTrackLength,"Length")
-     << " position: " 
-     << std::setw(3) << G4BestUnit(fEdepPos,"Length")
-     << G4endl;
+  G4AutoLock lock(&fMutex);
+  G4int nofDropped = fPending.size();
+  fPending.clear();
+  return nofDropped;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,117 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ChunkScheduler.cc
+/// \brief Implementation of the ChunkScheduler class
+
+#include "ChunkScheduler.hh"
+#include "SchedulerMessenger.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+  // weight of the last measurement in the smoothed event cost
+  const G4double kSmoothing = 0.2;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ChunkScheduler::ChunkScheduler()
+ : fMessenger(0),
+   fChunkTime(50*ms),
+   fMaxChunk(10000),
+   fEventCost(0.),
+   fNofChunks(0),
+   fNofEvents(0),
+   fLargestChunk(0)
+{
+  fMessenger = new SchedulerMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ChunkScheduler::~ChunkScheduler()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ChunkScheduler::Reset()
+{
+  // the event cost depends on the beam: measure it again
+  fEventCost = 0.;
+  fWorkers.clear();
+  fNofChunks = fNofEvents = fLargestChunk = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ChunkScheduler::NextChunk(G4int threadID, G4int nofRemaining, G4int nofWorkers)
+{
+  auto now = Clock::now();
+  if ( threadID < 0 ) threadID = 0;
+  if ( threadID >= G4int(fWorkers.size()) ) fWorkers.resize(threadID + 1);
+  auto& worker = fWorkers[threadID];
+
+  // Cost of the events of the previous chunk of this worker
+  if ( worker.fChunk > 0 ) {
+    std::chrono::duration<G4double> time = now - worker.fStart;
+    auto cost = time.count()*s/worker.fChunk;
+    fEventCost = ( fEventCost > 0. ) ? (1. - kSmoothing)*fEventCost + kSmoothing*cost : cost;
+  }
+
+  G4int chunk = 1;
+  if ( fEventCost > 0. ) chunk = G4int(fChunkTime/fEventCost);
+  // guided: at most half of the share of each worker in what is left
+  chunk = std::min(chunk, nofRemaining/(2*std::max(nofWorkers, 1)));
+  chunk = std::max(1, std::min(chunk, fMaxChunk));
+
+  worker.fStart = now;
+  worker.fChunk = chunk;
+  fNofChunks++;
+  fNofEvents += std::min(chunk, nofRemaining);
+  fLargestChunk = std::max(fLargestChunk, chunk);
+  return chunk;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ChunkScheduler::Print() const
+{
+  if ( fNofChunks == 0 ) return;
+  G4cout << "---> Adaptive batching: " << fNofEvents << " events in " << fNofChunks
+         << " chunks (mean " << std::setprecision(4) << G4double(fNofEvents)/fNofChunks
+         << ", largest " << fLargestChunk << "), event cost "
+         << G4BestUnit(fEventCost, "Time") << std::setprecision(6) << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
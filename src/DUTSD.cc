@@ -28,6 +28,7 @@
 /// \brief Implementation of the DUTSD class
 
 #include "DUTSD.hh"
+#include "SensorKernels.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4Step.hh"
 #include "G4ThreeVector.hh"
@@ -43,13 +44,13 @@
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-DUTSD::DUTSD(const G4String& name, const G4String& hitsCollectionName, G4int nofLayers)
+DUTSD::DUTSD(const G4String& name, G4int nofLayers,
+             G4double virtualThickness)
  : G4VSensitiveDetector(name),
-   fHitsCollection(nullptr),
-   fNofLayers(nofLayers)
-{
-  collectionName.insert(hitsCollectionName);
-}
+   fHitStore(nofLayers),
+   fNofLayers(nofLayers),
+   fSlicer(nofLayers, virtualThickness)
+{}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -58,20 +59,10 @@ DUTSD::~DUTSD(){
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void DUTSD::Initialize(G4HCofThisEvent* hce)
+void DUTSD::Initialize(G4HCofThisEvent*)
 {
-  // Create hits collection
-  fHitsCollection = new DUTHitsCollection(SensitiveDetectorName, collectionName[0]); 
-
-  // Add this collection in hce
-  auto hcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
-  hce->AddHitsCollection( hcID, fHitsCollection ); 
-
-  // Create hits
-  // fNofLayers for cells + one more for total sums 
-  for (G4int i=0; i<fNofLayers+3; i++ ) {
-    fHitsCollection->insert(new DUTHit());
-  }
+  // Zero the layers hit in the previous event
+  fHitStore.Clear();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -89,50 +80,43 @@ G4bool DUTSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 
   if ( edep==0. && stepLength == 0. ) return false;      
 
-  G4ThreeVector edepPos = ( step->GetPostStepPoint()->GetPosition() + step->GetPreStepPoint()->GetPosition() ) / 2;
+  SensorStep sensorStep;
+  sensorStep.fEdep = edep;
+  sensorStep.fStepLength = stepLength;
+  sensorStep.fPrePos = step->GetPreStepPoint()->GetPosition();
+  sensorStep.fPostPos = step->GetPostStepPoint()->GetPosition();
 
   auto touchable = (step->GetPreStepPoint()->GetTouchable());  
-  // Get sensor layer id 
-  auto layerNumber = touchable->GetCopyNumber(0);
+  // Get sensor layer id. The layers are only shifted in z in the wafer: the
+  // local x, y (pad readout) are the wafer ones
+  const auto& toLocal = touchable->GetHistory()->GetTopTransform();
+  sensorStep.fLocalPre = toLocal.TransformPoint(sensorStep.fPrePos);
+  sensorStep.fLocalPost = toLocal.TransformPoint(sensorStep.fPostPos);
+  if ( fSlicer.IsActive() ) {
+    // Single solid wafer: the layer follows from the local depth
+    sensorStep.fLayer = fSlicer.LayerOf(sensorStep.fLocalPre.z());
+  }
+  else {
+    sensorStep.fLayer = touchable->GetCopyNumber(0);
+  }
+  G4int layerNumber = sensorStep.fLayer;
   //G4cout << "Layer number: " << layerNumber << G4endl;
   
-  // Get layer name. This is either "Sapphire wafer 110 um (layer)" or "Sapphire wafer 150 um (layer)"
+  // Get layer name. This is "Sapphire wafer 110 um" or "Sapphire wafer 150 um",
+  // followed by " (layer)" unless virtual layers are used
   auto layerName = touchable->GetVolume()->GetName();
-  G4String detectorName = (layerName=="Sapphire wafer 110 um (layer)") ? "110um" : "150um";
+  G4String detectorName = (layerName.find("110 um") != std::string::npos) ? "110um" : "150um";
 
-  // Get hit accounting data for this layer
-  auto hit = (*fHitsCollection)[layerNumber];
-  if ( ! hit ) {
+  if ( layerNumber < 0 || layerNumber >= fNofLayers ) {
     G4ExceptionDescription msg;
-    msg << "Cannot access hit " << layerNumber; 
+    msg << "Layer " << layerNumber << " out of range"; 
     G4Exception("DUTSD::ProcessHits()",
       "MyCode0004", FatalException, msg);
   }         
 
-  // Get hit for total accounting
-  auto hitTotal = (*fHitsCollection)[fHitsCollection->entries()-1];
-  
-  // Get hit for large pad
-  auto hitTotalLarge = (*fHitsCollection)[fHitsCollection->entries()-3];
-  auto hitTotalSmall = (*fHitsCollection)[fHitsCollection->entries()-2];
-
-  // Add values
-  hit->Add(edep, edepPos);
-  hitTotal->Add(edep);
-  
-  auto planeRadius2 = (edepPos.getX()*edepPos.getX() + edepPos.getY()*edepPos.getY())/mm2;
-  auto preStep = step->GetPreStepPoint()->GetPosition();
-  auto postStep = step->GetPostStepPoint()->GetPosition();
-  auto planeRadius2Pre = preStep.getX()*preStep.getX() + preStep.getY()*preStep.getY();
-  auto planeRadius2Post = postStep.getX()*postStep.getX() + postStep.getY()*postStep.getY();
-  double largePadRadius2 = (5.50/2.0*mm); largePadRadius2 *= largePadRadius2;
-  double smallPadRadius2 = (1.6/2*mm); smallPadRadius2 *= smallPadRadius2;
-  if(planeRadius2 < largePadRadius2 && planeRadius2Pre < largePadRadius2 && planeRadius2Post < largePadRadius2){
-    hitTotalLarge->Add(edep);
-  }
-  if(planeRadius2 <= (1.6/2)*(1.6/2)*mm2){
-    hitTotalSmall->Add(edep);
-  }
+  // Add values: layers, total, pad sums and pads
+  SensorKernels::AddLayers(fHitStore, fSlicer, sensorStep);
+  SensorKernels::AddPads(fHitStore, sensorStep);
   
   // Kinetic energy of the track entering the DUT (accounting for energy lost in the 100 nm metal layer)
   if(step->GetPreStepPoint()->GetStepStatus() == fGeomBoundary && layerNumber == 0){
@@ -151,12 +135,10 @@ G4bool DUTSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 void DUTSD::EndOfEvent(G4HCofThisEvent*)
 {
   if ( verboseLevel>1 ) { 
-     auto nofHits = fHitsCollection->entries();
      G4cout
        << G4endl 
-       << "-------->Hits Collection: in this event they are " << nofHits 
-       << " hits in the tracker chambers: " << G4endl;
-     for ( std::size_t i=0; i<nofHits; ++i ) (*fHitsCollection)[i]->Print();
+       << "-------->Hit store of " << SensitiveDetectorName << ":" << G4endl;
+     fHitStore.Print();
   }
 }
 
@@ -27,8 +27,12 @@
 /// \brief Implementation of the DetectorConstruction class
 
 #include "DetectorConstruction.hh"
+#include "DetectorMessenger.hh"
 #include "DUTSD.hh"
 #include "FitpixSD.hh"
+#include "PhaseSpaceSD.hh"
+#include "AirGapModel.hh"
+#include "PadLayout.hh"
 #include "G4Material.hh"
 #include "G4NistManager.hh"
 #include "G4Element.hh"
@@ -40,6 +44,16 @@
 #include "G4PVPlacement.hh"
 #include "G4PVReplica.hh"
 #include "G4AssemblyVolume.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4UserLimits.hh"
+#include "G4RunManager.hh"
+#include "G4RunManagerKernel.hh"
+#include "G4VUserPhysicsList.hh"
+#include "G4VModularPhysicsList.hh"
+#include "G4FastSimulationPhysics.hh"
+#include "G4Threading.hh"
 
 #include "G4SDManager.hh"
 
@@ -48,6 +62,7 @@
 
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -55,14 +70,32 @@ DetectorConstruction::DetectorConstruction()
   :G4VUserDetectorConstruction(),
    fANbofLayers(110),
    fBNbofLayers(150),
-   fFitpixNbofLayers(100)
+   fFitpixNbofLayers(100),
+   fWaferThickness(110*um),
+   fWaferBThickness(150*um),
+   fFitpixThickness(300*um),
+   fVirtualLayers(false),
+   fFastAir(false),
+   fFastAirMinEkin(10*MeV),
+   fFastAirPhysics(false),
+   fAirGapRegion(nullptr),
+   fDUTPosition(),
+   fDUTBox(nullptr),
+   fPhaseSpacePlane(nullptr),
+   fRegions{nullptr, nullptr},
+   fRegionCut{0.7*mm, -1.},
+   fRegionMaxStep{-1., -1.},
+   fRegionMinEkin{-1., -1.},
+   fDetectorMessenger(nullptr)
 {
+  fDetectorMessenger = new DetectorMessenger(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::~DetectorConstruction()
 {
+  delete fDetectorMessenger;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -151,11 +184,9 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   
   // Sapphire pad 110 um parameters
   auto fPadMetalizationThickness = 100 * nm;
-	auto fWaferThickness = 110 * um;
   const double fWaferLayerNb = fANbofLayers;
   const double inch = 25.4*mm;
   // Sapphire pad 150 um parameters
-	auto fWaferBThickness = 150 * um;
   const double fWaferBLayerNb = fBNbofLayers;
   // PCB parameters
   auto pcbThickness = 1.57*mm;
@@ -172,8 +203,8 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   // Sapphire pad 110 um
   auto sapphireWaferS = new G4Tubs("Sapphire wafer", 0, 1*inch, fWaferThickness / 2., 0, 2*pi);
   auto sapphireWaferLayerS = new G4Tubs("Sapphire wafer", 0, 1*inch, (fWaferThickness/fWaferLayerNb) / 2., 0, 2*pi);
-  auto sapphirePadLargeMetS = new G4Tubs("Sapphire pad large metallization (d=5.50)", 0, (5.50/2)*mm, fPadMetalizationThickness / 2., 0, 2*pi);
-  auto sapphirePadSmallMetS = new G4Tubs("Sapphire pad small metallization (d=1.60)", 0, (1.60/2)*mm, fPadMetalizationThickness / 2., 0, 2*pi);
+  auto sapphirePadLargeMetS = new G4Tubs("Sapphire pad large metallization (d=5.50)", 0, PadLayout::kLargeRadius, fPadMetalizationThickness / 2., 0, 2*pi);
+  auto sapphirePadSmallMetS = new G4Tubs("Sapphire pad small metallization (d=1.60)", 0, PadLayout::kSmallRadius, fPadMetalizationThickness / 2., 0, 2*pi);
   auto sapphirePadHalfMoonBoolAS = new G4Tubs("Sapphire pad half-moon (boolA)", 0, 22*mm, fPadMetalizationThickness/2, 0, pi);
   auto sapphirePadHalfMoonBoolBS = new G4Box("Sapphire pad half-moon (boolB)", 44*mm /2, 24*mm /2, 1*cm /2);
   G4SubtractionSolid* sapphirePadHalfMoonS = new G4SubtractionSolid("Sapphire pad half-moon", sapphirePadHalfMoonBoolAS, sapphirePadHalfMoonBoolBS, 0, G4ThreeVector(0));  
@@ -184,35 +215,18 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   G4LogicalVolume* sapphirePadHalfMoonL = new G4LogicalVolume(sapphirePadHalfMoonS, AlMat, "Sapphire pad half-moon");
   G4ThreeVector sapphireWaferPos(0,0,0);
   G4ThreeVector halfMoonPos = sapphireWaferPos;
-  G4ThreeVector padLarge1Pos = G4ThreeVector(-10.5*mm, -15*mm, 0);
-  G4ThreeVector padLarge2Pos = G4ThreeVector(10.5*mm, -15*mm, 0);
-  G4ThreeVector padLarge3Pos = G4ThreeVector(10.5*mm, 15*mm, 0);
-  G4ThreeVector padLarge4Pos = G4ThreeVector(-10.5*mm, 15*mm, 0);
-  G4ThreeVector padSmall1Pos = G4ThreeVector(-5*mm, -20*mm, 0);
-  G4ThreeVector padSmall2Pos = G4ThreeVector(5*mm, -20*mm, 0);
-  G4ThreeVector padSmall3Pos = G4ThreeVector(5*mm, 20*mm, 0);
-  G4ThreeVector padSmall4Pos = G4ThreeVector(-5*mm, 20*mm, 0);
+  // Pad positions and sizes are in PadLayout.hh, shared with DUTSD
+  G4ThreeVector padSmall4Pos = G4ThreeVector(PadLayout::kPads[PadLayout::kBeamPad].fX, PadLayout::kPads[PadLayout::kBeamPad].fY, 0);
   double zMetSurfBoundaryPos = fWaferThickness/2+fPadMetalizationThickness/2;
   new G4PVPlacement(0, sapphireWaferPos, sapphireWaferL, "Sapphire wafer 110 um", sapphire110WrapperL, false, 0, false);
   static double layerThickness = fWaferThickness/fWaferLayerNb;
   G4ThreeVector layerPos = G4ThreeVector(0, 0, fWaferThickness/2 - layerThickness/2);
-  for(G4int i=0; i<fWaferLayerNb; i++){
+  // With virtual layers the wafer stays a single solid and DUTSD bins the depth
+  for(G4int i=0; i<fWaferLayerNb && !fVirtualLayers; i++){
     new G4PVPlacement(0, layerPos, sapphireWaferLayerL, "Sapphire wafer 110 um (layer)", sapphireWaferL, false, i, false);
     layerPos -= G4ThreeVector(0, 0, layerThickness);
   }
-  new G4PVPlacement(0, padLarge1Pos + G4ThreeVector(0,0,zMetSurfBoundaryPos), sapphirePadLargeMetL, "Sapphire pad 1 large metallization top", sapphireWaferL, false, 0, false);
-  new G4PVPlacement(0, padLarge1Pos - G4ThreeVector(0,0,zMetSurfBoundaryPos), sapphirePadLargeMetL, "Sapphire pad 1 large metallization bottom", sapphireWaferL, false, 0, false);
-  new G4PVPlacement(0, padLarge2Pos + G4ThreeVector(0,0,zMetSurfBoundaryPos), sapphirePadLargeMetL, "Sapphire pad 2 large metallization top", sapphireWaferL, false, 0, false);
-  new G4PVPlacement(0, padLarge2Pos - G4ThreeVector(0,0,zMetSurfBoundaryPos), sapphirePadLargeMetL, "Sapphire pad 2 large metallization bottom", sapphireWaferL, false, 0, false);
-  new G4PVPlacement(0, padLarge3Pos + G4ThreeVector(0,0,zMetSurfBoundaryPos), sapphirePadLargeMetL, "Sapphire pad 3 large metallization top", sapphireWaferL, false, 0, false);
-  new G4PVPlacement(0, padLarge4Pos + G4ThreeVector(0,0,zMetSurfBoundaryPos), sapphirePadLargeMetL, "Sapphire pad 4 large metallization top", sapphireWaferL, false, 0, false);
-  new G4PVPlacement(0, halfMoonPos  - G4ThreeVector(0,0,zMetSurfBoundaryPos), sapphirePadHalfMoonL, "Sapphire half-moon metallization", sapphireWaferL, false, 0, false);
-  new G4PVPlacement(0, padSmall1Pos + G4ThreeVector(0,0,zMetSurfBoundaryPos), sapphirePadSmallMetL, "Sapphire pad 1 small metallization top", sapphireWaferL, false, 0, false);
-  new G4PVPlacement(0, padSmall1Pos - G4ThreeVector(0,0,zMetSurfBoundaryPos), sapphirePadSmallMetL, "Sapphire pad 1 small metallization bottom", sapphireWaferL, false, 0, false);
-  new G4PVPlacement(0, padSmall2Pos + G4ThreeVector(0,0,zMetSurfBoundaryPos), sapphirePadSmallMetL, "Sapphire pad 2 small metallization top", sapphireWaferL, false, 0, false);
-  new G4PVPlacement(0, padSmall2Pos - G4ThreeVector(0,0,zMetSurfBoundaryPos), sapphirePadSmallMetL, "Sapphire pad 2 small metallization bottom", sapphireWaferL, false, 0, false);
-  new G4PVPlacement(0, padSmall3Pos + G4ThreeVector(0,0,zMetSurfBoundaryPos), sapphirePadSmallMetL, "Sapphire pad 3 small metallization top", sapphireWaferL, false, 0, false);
-  new G4PVPlacement(0, padSmall4Pos + G4ThreeVector(0,0,zMetSurfBoundaryPos), sapphirePadSmallMetL, "Sapphire pad 4 small metallization top", sapphireWaferL, false, 0, false);
+  PlacePadMetallizations(sapphireWaferL, zMetSurfBoundaryPos, sapphirePadLargeMetL, sapphirePadSmallMetL, sapphirePadHalfMoonL, halfMoonPos);
   
 
   // Sapphire pad 150 um
@@ -225,24 +239,11 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   new G4PVPlacement(0, sapphireWaferPos, sapphireWaferBL, "Sapphire wafer 150 um", sapphire150WrapperL, false, 0, false);
   static double layerBThickness = fWaferBThickness/fWaferBLayerNb;
   layerPos = G4ThreeVector(0, 0, fWaferBThickness/2 - layerBThickness/2);
-  for(G4int i=0; i<fWaferBLayerNb; i++){
+  for(G4int i=0; i<fWaferBLayerNb && !fVirtualLayers; i++){
     new G4PVPlacement(0, layerPos, sapphireWaferBLayerL, "Sapphire wafer 150 um (layer)", sapphireWaferBL, false, i, false);
     layerPos -= G4ThreeVector(0, 0, layerBThickness);
   }
-  new G4PVPlacement(0, padLarge1Pos + G4ThreeVector(0,0,zMetSurfBoundaryBPos), sapphirePadLargeMetL, "Sapphire pad 1 large metallization top", sapphireWaferBL, false, 0, false);
-  new G4PVPlacement(0, padLarge1Pos - G4ThreeVector(0,0,zMetSurfBoundaryBPos), sapphirePadLargeMetL, "Sapphire pad 1 large metallization bottom", sapphireWaferBL, false, 0, false);
-  new G4PVPlacement(0, padLarge2Pos + G4ThreeVector(0,0,zMetSurfBoundaryBPos), sapphirePadLargeMetL, "Sapphire pad 2 large metallization top", sapphireWaferBL, false, 0, false);
-  new G4PVPlacement(0, padLarge2Pos - G4ThreeVector(0,0,zMetSurfBoundaryBPos), sapphirePadLargeMetL, "Sapphire pad 2 large metallization bottom", sapphireWaferBL, false, 0, false);
-  new G4PVPlacement(0, padLarge3Pos + G4ThreeVector(0,0,zMetSurfBoundaryBPos), sapphirePadLargeMetL, "Sapphire pad 3 large metallization top", sapphireWaferBL, false, 0, false);
-  new G4PVPlacement(0, padLarge4Pos + G4ThreeVector(0,0,zMetSurfBoundaryBPos), sapphirePadLargeMetL, "Sapphire pad 4 large metallization top", sapphireWaferBL, false, 0, false);
-  new G4PVPlacement(0, halfMoonPos  - G4ThreeVector(0,0,zMetSurfBoundaryBPos), sapphirePadHalfMoonL, "Sapphire half-moon metallization", sapphireWaferBL, false, 0, false);
-  new G4PVPlacement(0, padSmall1Pos + G4ThreeVector(0,0,zMetSurfBoundaryBPos), sapphirePadSmallMetL, "Sapphire pad 1 small metallization top", sapphireWaferBL, false, 0, false);
-  new G4PVPlacement(0, padSmall1Pos - G4ThreeVector(0,0,zMetSurfBoundaryBPos), sapphirePadSmallMetL, "Sapphire pad 1 small metallization bottom", sapphireWaferBL, false, 0, false);
-  new G4PVPlacement(0, padSmall2Pos + G4ThreeVector(0,0,zMetSurfBoundaryBPos), sapphirePadSmallMetL, "Sapphire pad 2 small metallization top", sapphireWaferBL, false, 0, false);
-  new G4PVPlacement(0, padSmall2Pos - G4ThreeVector(0,0,zMetSurfBoundaryBPos), sapphirePadSmallMetL, "Sapphire pad 2 small metallization bottom", sapphireWaferBL, false, 0, false);
-  new G4PVPlacement(0, padSmall3Pos + G4ThreeVector(0,0,zMetSurfBoundaryBPos), sapphirePadSmallMetL, "Sapphire pad 3 small metallization top", sapphireWaferBL, false, 0, false);
-  new G4PVPlacement(0, padSmall4Pos + G4ThreeVector(0,0,zMetSurfBoundaryBPos), sapphirePadSmallMetL, "Sapphire pad 4 small metallization top", sapphireWaferBL, false, 0, false);
-
+  PlacePadMetallizations(sapphireWaferBL, zMetSurfBoundaryBPos, sapphirePadLargeMetL, sapphirePadSmallMetL, sapphirePadHalfMoonL, halfMoonPos);
 
 
   // PCB support
@@ -288,8 +289,21 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   G4Transform3D canisterRotPos = G4Transform3D(G4RotationMatrix(0,0,0), G4ThreeVector(0,0,0));
   dutBoxWrapper->AddPlacedVolume(dutBoxL, canisterRotPos);
   //
-  G4Transform3D dutBoxRotPos = G4Transform3D(G4RotationMatrix(0,0,0), -padSmall4Pos);
+  G4Transform3D dutBoxRotPos = G4Transform3D(G4RotationMatrix(0,0,0), -padSmall4Pos + fDUTPosition);
   dutBoxWrapper->MakeImprint(worldL, dutBoxRotPos);
+  fDUTBox = dutBoxWrapper;
+
+
+  // Phase-space scoring plane 5 mm above the DUT box cover, recording what
+  // the upstream beamline delivers to the box (see PhaseSpaceSD)
+  if(!fPhaseSpaceFile.empty()){
+    double planeThickness = 1*um;
+    G4Box* phaseSpacePlaneS = new G4Box("Phase-space plane", (boxSizeXY+2*cm) /2, (boxSizeXY+2*cm) /2, planeThickness /2);
+    G4LogicalVolume* phaseSpacePlaneL = new G4LogicalVolume(phaseSpacePlaneS, defaultMaterial, "Phase-space plane");
+    G4ThreeVector phaseSpacePlanePos = -padSmall4Pos + fDUTPosition + G4ThreeVector(0, 0, boxSizeZ/2 + 5*mm);
+    fPhaseSpacePlane = new G4PVPlacement(0, phaseSpacePlanePos, phaseSpacePlaneL, "Phase-space plane", worldL, false, 0, false);
+    phaseSpacePlaneL->SetVisAttributes(G4VisAttributes::GetInvisible());
+  }
 
 
   // Additional geometry in the beamline (from @Luca's email)
@@ -304,8 +318,8 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   double siPixelDetThickness = (300+400)*um;
   G4Box* tiSurfS = new G4Box("Ti surface", transvSize / 2., transvSize / 2., tiSurfThickness / 2.);
   G4LogicalVolume* tiSurfL = new G4LogicalVolume(tiSurfS, TiMat, "Ti surface");
-  G4Box* siPixelDetS = new G4Box("Silicon pixel detector", transvSize / 2., transvSize / 2., (siPixelDetThickness-400*um) / 2.);
-  G4Box* siPixelDetLayerS = new G4Box("Silicon pixel detector (layer)", transvSize / 2., transvSize / 2., (siPixelDetThickness-400*um)/fFitpixNbofLayers / 2.);
+  G4Box* siPixelDetS = new G4Box("Silicon pixel detector", transvSize / 2., transvSize / 2., fFitpixThickness / 2.);
+  G4Box* siPixelDetLayerS = new G4Box("Silicon pixel detector (layer)", transvSize / 2., transvSize / 2., fFitpixThickness/fFitpixNbofLayers / 2.);
   G4Box* siPixelDetAsicS = new G4Box("Silicon pixel detector (asic)", transvSize / 2., transvSize / 2., (siPixelDetThickness-300*um) / 2.);
   G4LogicalVolume* siPixelDetL = new G4LogicalVolume(siPixelDetS, SiMat, "Silicon pixel detector");
   G4LogicalVolume* siPixelDetLayerL = new G4LogicalVolume(siPixelDetLayerS, SiMat, "Silicon pixel detector (layer)");
@@ -316,15 +330,38 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   new G4PVPlacement(0, tiSurfPos, tiSurfL, "Ti surface", worldL, 0, false);
   //
   new G4PVPlacement(0, siPixelDetPos, siPixelDetL, "Silicon pixel detector", worldL, 0, false);
-  static double layerFitpixThickness = (siPixelDetThickness-400*um)/fFitpixNbofLayers;
-  layerPos = G4ThreeVector(0, 0, (siPixelDetThickness-400*um)/2 - layerFitpixThickness/2);
-  for(G4int i=0; i<fFitpixNbofLayers; i++){
+  static double layerFitpixThickness = fFitpixThickness/fFitpixNbofLayers;
+  layerPos = G4ThreeVector(0, 0, fFitpixThickness/2 - layerFitpixThickness/2);
+  for(G4int i=0; i<fFitpixNbofLayers && !fVirtualLayers; i++){
     new G4PVPlacement(0, layerPos, siPixelDetLayerL, "Silicon pixel detector (layer)", siPixelDetL, false, i, false);
     layerPos -= G4ThreeVector(0, 0, layerFitpixThickness);
   }
   new G4PVPlacement(0, G4ThreeVector(0, 0, -siPixelDetThickness/2), siPixelDetAsicL, "Silicon pixel detector (asic)", siPixelDetL, false, 0);
 
 
+  // Air gap envelopes for the fast simulation (see AirGapModel), 1 mm away
+  // from the window and the Fitpix, 1 cm above the box (and phase-space plane)
+  if(fFastAir){
+    double gapSizeXY = 10*cm;
+    double gapWindowTop = tiSurfPos.z() - tiSurfThickness/2 - 1*mm;
+    double gapWindowBottom = siPixelDetPos.z() + fFitpixThickness/2 + 1*mm;
+    double gapBoxTop = siPixelDetPos.z() - fFitpixThickness/2 - siPixelDetThickness - 1*mm;
+    double gapBoxBottom = -padSmall4Pos.z() + boxSizeZ/2 + 1*cm;
+    G4Box* airGapWindowS = new G4Box("Air gap (window-Fitpix)", gapSizeXY /2, gapSizeXY /2, (gapWindowTop-gapWindowBottom) /2);
+    G4Box* airGapBoxS = new G4Box("Air gap (Fitpix-box)", gapSizeXY /2, gapSizeXY /2, (gapBoxTop-gapBoxBottom) /2);
+    G4LogicalVolume* airGapWindowL = new G4LogicalVolume(airGapWindowS, defaultMaterial, "Air gap (window-Fitpix)");
+    G4LogicalVolume* airGapBoxL = new G4LogicalVolume(airGapBoxS, defaultMaterial, "Air gap (Fitpix-box)");
+    new G4PVPlacement(0, G4ThreeVector(siPixelDetPos.x(), siPixelDetPos.y(), (gapWindowTop+gapWindowBottom)/2), airGapWindowL, "Air gap (window-Fitpix)", worldL, false, 0, false);
+    new G4PVPlacement(0, G4ThreeVector(siPixelDetPos.x(), siPixelDetPos.y(), (gapBoxTop+gapBoxBottom)/2), airGapBoxL, "Air gap (Fitpix-box)", worldL, false, 0, false);
+    airGapWindowL->SetVisAttributes(G4VisAttributes::GetInvisible());
+    airGapBoxL->SetVisAttributes(G4VisAttributes::GetInvisible());
+
+    fAirGapRegion = new G4Region("AirGap");
+    fAirGapRegion->AddRootLogicalVolume(airGapWindowL);
+    fAirGapRegion->AddRootLogicalVolume(airGapBoxL);
+  }
+
+
 
 	// Detector placement
 	// X-Axis detector (strips parallel to the x)
@@ -386,7 +423,7 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   G4cout
     << G4endl 
     << "------------------------------------------------------------" << G4endl
-    << "---> a) The DUT is " << fWaferLayerNb << " layers of: "
+    << "---> a) The DUT is " << fWaferLayerNb << (fVirtualLayers ? " virtual" : "") << " layers of: "
     << layerThickness/mm << "mm of " << sapphireMat->GetName() 
     << G4endl
     << "------------------------------------------------------------" << G4endl;
@@ -394,15 +431,27 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   G4cout
     << G4endl 
     << "------------------------------------------------------------" << G4endl
-    << "---> b) The DUT is " << fWaferBLayerNb << " layers of: "
+    << "---> b) The DUT is " << fWaferBLayerNb << (fVirtualLayers ? " virtual" : "") << " layers of: "
     << layerBThickness/mm << "mm of " << sapphireMat->GetName() 
     << G4endl
     << "------------------------------------------------------------" << G4endl;
 
 
-  // Create Target G4Region and add logical volume
-  //fRegion = new G4Region("Active sensor region");
-  //fRegion->AddRootLogicalVolume(sapphireWaferLayerL);
+  // Regions: the sensors keep their own cuts whatever the default cut is,
+  // the passive material around them inherits the default cut
+  fRegions[kSensorRegion] = new G4Region("Sensor");
+  fRegions[kSensorRegion]->AddRootLogicalVolume(sapphireWaferL);
+  fRegions[kSensorRegion]->AddRootLogicalVolume(sapphireWaferBL);
+  fRegions[kSensorRegion]->AddRootLogicalVolume(siPixelDetL);
+  fRegions[kPassiveRegion] = new G4Region("Passive");
+  fRegions[kPassiveRegion]->AddRootLogicalVolume(dutBoxL);
+  fRegions[kPassiveRegion]->AddRootLogicalVolume(sapphire110WrapperL);
+  fRegions[kPassiveRegion]->AddRootLogicalVolume(sapphire150WrapperL);
+  fRegions[kPassiveRegion]->AddRootLogicalVolume(tiSurfL);
+  fRegions[kPassiveRegion]->AddRootLogicalVolume(siPixelDetAsicL);
+  for(G4int i=0; i<kNofRegions; i++){
+    ApplyRegionSettings(i);
+  }
 
   //
   //always return the physical World
@@ -411,22 +460,170 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void DetectorConstruction::PlacePadMetallizations(G4LogicalVolume* waferL, G4double zSurface,
+                                                  G4LogicalVolume* largeL, G4LogicalVolume* smallL,
+                                                  G4LogicalVolume* halfMoonL, const G4ThreeVector& halfMoonPos)
+{
+  // Pads on the top face (some also on the bottom one), half-moon on the bottom face
+  for(const auto& pad : PadLayout::kPads){
+    G4ThreeVector padPos(pad.fX, pad.fY, 0);
+    auto padL = pad.fLarge ? largeL : smallL;
+    G4String name = "Sapphire pad " + std::to_string(pad.fNumber) + (pad.fLarge ? " large" : " small") + " metallization";
+    new G4PVPlacement(0, padPos + G4ThreeVector(0,0,zSurface), padL, name + " top", waferL, false, 0, false);
+    if(pad.fBottom){
+      new G4PVPlacement(0, padPos - G4ThreeVector(0,0,zSurface), padL, name + " bottom", waferL, false, 0, false);
+    }
+  }
+  new G4PVPlacement(0, halfMoonPos  - G4ThreeVector(0,0,zSurface), halfMoonL, "Sapphire half-moon metallization", waferL, false, 0, false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRegionCut(G4int region, G4double cut)
+{
+  fRegionCut[region] = cut;
+  ApplyRegionSettings(region);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRegionMaxStep(G4int region, G4double maxStep)
+{
+  fRegionMaxStep[region] = maxStep;
+  ApplyRegionSettings(region);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRegionMinEkin(G4int region, G4double minEkin)
+{
+  fRegionMinEkin[region] = minEkin;
+  ApplyRegionSettings(region);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetDUTPosition(G4double x, G4double y)
+{
+  G4ThreeVector position(x, y, 0.);
+  auto shift = position - fDUTPosition;
+  fDUTPosition = position;
+  if(position != G4ThreeVector()){
+    G4ExceptionDescription msg;
+    msg << "DUT box off the beam axis: the etotLP/etotSP sums (AUX and DUTEvents)" << G4endl
+        << "are still taken in circles around the beam axis and no longer match" << G4endl
+        << "the pads; use the pad readout (Pads tree) instead.";
+    G4Exception("DetectorConstruction::SetDUTPosition()",
+      "MyCode0028", JustWarning, msg);
+  }
+  // Before the geometry is built, the position is used in DefineVolumes()
+  if(!fDUTBox) return;
+
+  auto volume = fDUTBox->GetVolumesIterator();
+  for(std::size_t i = 0; i < fDUTBox->TotalImprintedVolumes(); ++i, ++volume){
+    (*volume)->SetTranslation((*volume)->GetTranslation() + shift);
+  }
+  if(fPhaseSpacePlane) fPhaseSpacePlane->SetTranslation(fPhaseSpacePlane->GetTranslation() + shift);
+  G4RunManager::GetRunManager()->GeometryHasBeenModified();
+
+  G4cout << "---> DUT box moved to " << G4BestUnit(fDUTPosition, "Length")
+         << " from the nominal position" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetFastAir(G4bool value)
+{
+  fFastAir = value;
+
+  // PreInit (master): without the air gaps the e+/e- do not pay for the
+  // fast simulation manager process at each step
+  if(!value || fFastAirPhysics || !G4Threading::IsMasterThread()) return;
+  auto physicsList = dynamic_cast<G4VModularPhysicsList*>(
+    G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList());
+  if(!physicsList) return;
+  auto fastSimulationPhysics = new G4FastSimulationPhysics();
+  fastSimulationPhysics->ActivateFastSimulation("e-");
+  fastSimulationPhysics->ActivateFastSimulation("e+");
+  physicsList->RegisterPhysics(fastSimulationPhysics);
+  fFastAirPhysics = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::ApplyRegionSettings(G4int id)
+{
+  // Before the geometry is built, the settings are applied in DefineVolumes()
+  auto region = fRegions[id];
+  if(!region) return;
+
+  // The passive cut is the default one, so that it also holds in the air
+  if(fRegionCut[id] > 0){
+    if(id == kPassiveRegion){
+      G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList()->SetDefaultCutValue(fRegionCut[id]);
+    }
+    else{
+      if(!region->GetProductionCuts()) region->SetProductionCuts(new G4ProductionCuts());
+      region->GetProductionCuts()->SetProductionCut(fRegionCut[id]);
+    }
+  }
+
+  // Step limit and energy threshold, applied by G4StepLimiterPhysics
+  if(fRegionMaxStep[id] > 0 || fRegionMinEkin[id] > 0 || region->GetUserLimits()){
+    auto limits = region->GetUserLimits();
+    if(!limits){
+      limits = new G4UserLimits();
+      region->SetUserLimits(limits);
+    }
+    limits->SetMaxAllowedStep(fRegionMaxStep[id] > 0 ? fRegionMaxStep[id] : DBL_MAX);
+    limits->SetUserMinEkine(fRegionMinEkin[id] > 0 ? fRegionMinEkin[id] : 0.);
+    if(id == kPassiveRegion){
+      // the air of the world, and of the air gap envelopes if any
+      G4RegionStore::GetInstance()->GetRegion("DefaultRegionForTheWorld", false)->SetUserLimits(limits);
+      if(fAirGapRegion) fAirGapRegion->SetUserLimits(limits);
+    }
+  }
+
+  G4cout << "---> Region " << region->GetName() << ":";
+  if(fRegionCut[id] > 0) G4cout << " cut " << G4BestUnit(fRegionCut[id], "Length");
+  else G4cout << " default cut";
+  if(fRegionMaxStep[id] > 0) G4cout << ", max step " << G4BestUnit(fRegionMaxStep[id], "Length");
+  if(fRegionMinEkin[id] > 0) G4cout << ", min Ekin " << G4BestUnit(fRegionMinEkin[id], "Energy");
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void DetectorConstruction::ConstructSDandField()
 {
   G4SDManager::GetSDMpointer()->SetVerboseLevel(1);
   
   // Sensitive detectors
-  auto sensor110 = new DUTSD("Sensor 110 um", "DUTAHitsCollection", fANbofLayers);
-  auto sensor150 = new DUTSD("Sensor 150 um", "DUTBHitsCollection", fBNbofLayers);
+  // With virtual layers the SDs sit on the whole wafer and get its thickness
+  // to compute the depth bin of each step
+  auto sensor110 = new DUTSD("Sensor 110 um", fANbofLayers, fVirtualLayers ? fWaferThickness : 0.);
+  auto sensor150 = new DUTSD("Sensor 150 um", fBNbofLayers, fVirtualLayers ? fWaferBThickness : 0.);
   G4SDManager::GetSDMpointer()->AddNewDetector(sensor110);
   G4SDManager::GetSDMpointer()->AddNewDetector(sensor150);
-  SetSensitiveDetector("Sapphire wafer 110 um (layer)", sensor110);
-  SetSensitiveDetector("Sapphire wafer 150 um (layer)", sensor150);
+  SetSensitiveDetector(fVirtualLayers ? "Sapphire wafer 110 um" : "Sapphire wafer 110 um (layer)", sensor110);
+  SetSensitiveDetector(fVirtualLayers ? "Sapphire wafer 150 um" : "Sapphire wafer 150 um (layer)", sensor150);
   
   // Fitpix detector
-  auto fitpix = new FitpixSD("Fitpix", "FitpixHitsCollection", fFitpixNbofLayers);
+  auto fitpix = new FitpixSD("Fitpix", fFitpixNbofLayers, fVirtualLayers ? fFitpixThickness : 0.);
   G4SDManager::GetSDMpointer()->AddNewDetector(fitpix);
-  SetSensitiveDetector("Silicon pixel detector (layer)", fitpix);
+  SetSensitiveDetector(fVirtualLayers ? "Silicon pixel detector" : "Silicon pixel detector (layer)", fitpix);
+
+  // Phase-space recording
+  if(!fPhaseSpaceFile.empty()){
+    auto phaseSpace = new PhaseSpaceSD("PhaseSpace", fPhaseSpaceFile);
+    G4SDManager::GetSDMpointer()->AddNewDetector(phaseSpace);
+    SetSensitiveDetector("Phase-space plane", phaseSpace);
+  }
+
+  // Fast simulation in the air gaps (the model is registered to the region)
+  if(fAirGapRegion){
+    new AirGapModel("AirGapModel", fAirGapRegion, fFastAirMinEkin);
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
\ No newline at end of file
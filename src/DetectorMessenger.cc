@@ -0,0 +1,171 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm4/src/DetectorMessenger.cc
+/// \brief Implementation of the DetectorMessenger class
+//
+//
+//
+// 
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "DetectorMessenger.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+
+
+DetectorMessenger::DetectorMessenger(DetectorConstruction* detector)
+ :G4UImessenger(),
+  fDetector(detector),
+  fDetDir(0),
+  fVirtualLayersCmd(0),
+  fPhaseSpaceCmd(0),
+  fFastAirCmd(0),
+  fFastAirMinEkinCmd(0),
+  fDUTPositionCmd(0)
+{
+  fDetDir = new G4UIdirectory("/btf/det/");
+  fDetDir->SetGuidance("BTF setup geometry control");
+
+  fVirtualLayersCmd = new G4UIcmdWithABool("/btf/det/setVirtualLayers",this);
+  fVirtualLayersCmd->SetGuidance("build each wafer as a single solid and slice it in depth in the SD");
+  fVirtualLayersCmd->SetGuidance("instead of placing one volume per layer");
+  fVirtualLayersCmd->SetParameterName("virtualLayers", true);
+  fVirtualLayersCmd->SetDefaultValue(true);
+  fVirtualLayersCmd->AvailableForStates(G4State_PreInit);
+
+  fPhaseSpaceCmd = new G4UIcmdWithAString("/btf/det/recordPhaseSpace",this);
+  fPhaseSpaceCmd->SetGuidance("place a scoring plane in front of the DUT box and write the particles");
+  fPhaseSpaceCmd->SetGuidance("crossing it to the given binary file (one file per worker thread).");
+  fPhaseSpaceCmd->SetGuidance("The particles are killed on the plane; replay with /btf/gun/replayPhaseSpace");
+  fPhaseSpaceCmd->SetParameterName("fileName", false);
+  fPhaseSpaceCmd->AvailableForStates(G4State_PreInit);
+
+  fFastAirCmd = new G4UIcmdWithABool("/btf/det/setFastAir",this);
+  fFastAirCmd->SetGuidance("place air envelopes between the exit window, the Fitpix and the DUT box");
+  fFastAirCmd->SetGuidance("and transport the e+/e- through them in one step (parametrised energy");
+  fFastAirCmd->SetGuidance("loss and multiple scattering). /param/inActivateModel AirGapModel");
+  fFastAirCmd->SetGuidance("goes back to the full transport for validation");
+  fFastAirCmd->SetParameterName("fastAir", true);
+  fFastAirCmd->SetDefaultValue(true);
+  fFastAirCmd->AvailableForStates(G4State_PreInit);
+
+  fFastAirMinEkinCmd = new G4UIcmdWithADoubleAndUnit("/btf/det/fastAirMinEkin",this);
+  fFastAirMinEkinCmd->SetGuidance("full transport in the air gaps below this kinetic energy");
+  fFastAirMinEkinCmd->SetParameterName("minEkin", false);
+  fFastAirMinEkinCmd->SetUnitCategory("Energy");
+  fFastAirMinEkinCmd->AvailableForStates(G4State_PreInit);
+
+  fDUTPositionCmd = new G4UIcommand("/btf/det/dutPosition",this);
+  fDUTPositionCmd->SetGuidance("transverse position of the DUT box relative to the nominal one");
+  fDUTPositionCmd->SetGuidance("(small pad 4 on the beam axis); between runs the box is moved");
+  fDUTPositionCmd->SetGuidance("without rebuilding the geometry");
+  auto xPrm = new G4UIparameter("x", 'd', false);
+  fDUTPositionCmd->SetParameter(xPrm);
+  auto yPrm = new G4UIparameter("y", 'd', false);
+  fDUTPositionCmd->SetParameter(yPrm);
+  auto unitPrm = new G4UIparameter("unit", 's', true);
+  unitPrm->SetDefaultUnit("mm");
+  fDUTPositionCmd->SetParameter(unitPrm);
+  fDUTPositionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // Cuts and user limits of the sensor and passive regions
+  const G4String regionNames[DetectorConstruction::kNofRegions] = {"sensor", "passive"};
+  for (G4int i=0; i<DetectorConstruction::kNofRegions; i++) {
+    fRegionCutCmd[i] = new G4UIcmdWithADoubleAndUnit("/btf/det/"+regionNames[i]+"Cut",this);
+    fRegionCutCmd[i]->SetGuidance("production cut (range) in the "+regionNames[i]+" region");
+    if (i == DetectorConstruction::kPassiveRegion)
+      fRegionCutCmd[i]->SetGuidance("(also the default cut, i.e. the cut in the air)");
+    fRegionCutCmd[i]->SetParameterName("cut", false);
+    fRegionCutCmd[i]->SetRange("cut>0.");
+    fRegionCutCmd[i]->SetUnitCategory("Length");
+    fRegionCutCmd[i]->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fRegionMaxStepCmd[i] = new G4UIcmdWithADoubleAndUnit("/btf/det/"+regionNames[i]+"MaxStep",this);
+    fRegionMaxStepCmd[i]->SetGuidance("maximum step length in the "+regionNames[i]+" region (<= 0: no limit)");
+    fRegionMaxStepCmd[i]->SetParameterName("maxStep", false);
+    fRegionMaxStepCmd[i]->SetUnitCategory("Length");
+    fRegionMaxStepCmd[i]->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fRegionMinEkinCmd[i] = new G4UIcmdWithADoubleAndUnit("/btf/det/"+regionNames[i]+"MinEkin",this);
+    fRegionMinEkinCmd[i]->SetGuidance("kill the tracks below this kinetic energy in the "+regionNames[i]+" region");
+    fRegionMinEkinCmd[i]->SetGuidance("(<= 0: no threshold)");
+    fRegionMinEkinCmd[i]->SetParameterName("minEkin", false);
+    fRegionMinEkinCmd[i]->SetUnitCategory("Energy");
+    fRegionMinEkinCmd[i]->AvailableForStates(G4State_PreInit, G4State_Idle);
+  }
+}
+
+
+
+DetectorMessenger::~DetectorMessenger()
+{
+  delete fDetDir;
+  delete fVirtualLayersCmd;
+  delete fPhaseSpaceCmd;
+  delete fFastAirCmd;
+  delete fFastAirMinEkinCmd;
+  delete fDUTPositionCmd;
+  for (G4int i=0; i<DetectorConstruction::kNofRegions; i++) {
+    delete fRegionCutCmd[i];
+    delete fRegionMaxStepCmd[i];
+    delete fRegionMinEkinCmd[i];
+  }
+}
+
+
+
+void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fVirtualLayersCmd) fDetector->SetVirtualLayers(fVirtualLayersCmd->GetNewBoolValue(newValue));
+  if (command == fPhaseSpaceCmd) fDetector->SetPhaseSpaceFile(newValue);
+  if (command == fFastAirCmd) fDetector->SetFastAir(fFastAirCmd->GetNewBoolValue(newValue));
+  if (command == fFastAirMinEkinCmd) fDetector->SetFastAirMinEkin(fFastAirMinEkinCmd->GetNewDoubleValue(newValue));
+  if (command == fDUTPositionCmd) {
+    G4double x, y;
+    G4String unit;
+    std::istringstream is(newValue);
+    is >> x >> y >> unit;
+    fDetector->SetDUTPosition(x*G4UIcommand::ValueOf(unit), y*G4UIcommand::ValueOf(unit));
+  }
+  for (G4int i=0; i<DetectorConstruction::kNofRegions; i++) {
+    if (command == fRegionCutCmd[i])
+      fDetector->SetRegionCut(i, fRegionCutCmd[i]->GetNewDoubleValue(newValue));
+    if (command == fRegionMaxStepCmd[i])
+      fDetector->SetRegionMaxStep(i, fRegionMaxStepCmd[i]->GetNewDoubleValue(newValue));
+    if (command == fRegionMinEkinCmd[i])
+      fDetector->SetRegionMinEkin(i, fRegionMinEkinCmd[i]->GetNewDoubleValue(newValue));
+  }
+}
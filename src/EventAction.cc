@@ -31,14 +31,19 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #include "EventAction.hh"
+#include "RunAction.hh"
+#include "OverlayEngine.hh"
+#include "BunchAssembler.hh"
+#include "AsyncWriter.hh"
+#include "SubEventInformation.hh"
 #include "DUTSD.hh"
-#include "DUTHit.hh"
+#include "FitpixSD.hh"
+#include "SensorKernels.hh"
 #include "Analysis.hh"
 
 #include "G4RunManager.hh"
 #include "G4Event.hh"
 #include "G4SDManager.hh"
-#include "G4HCofThisEvent.hh"
 #include "G4UnitsTable.hh"
 
 #include "Randomize.hh"
@@ -46,11 +51,13 @@
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-EventAction::EventAction()
+EventAction::EventAction(RunAction* runAction, OverlayEngine* overlay)
 :G4UserEventAction(),
- fdutAHCID(-1),
- fdutBHCID(-1),
- ffitpixHCID(-1),
+ fRunAction(runAction),
+ fOverlay(overlay),
+ fDutAStore(nullptr),
+ fDutBStore(nullptr),
+ fFitpixStore(nullptr),
  fTotalEnergyDeposit(0.),
  fTotalEnergyDeposit_dutB(0.),
  fTotalEnergyDeposit_fitpix(0.)
@@ -61,24 +68,24 @@ EventAction::EventAction()
 
 EventAction::~EventAction()
 {
+  delete fOverlay;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-DUTHitsCollection* EventAction::GetHitsCollection(G4int hcID, const G4Event* event) const
+const HitStore& EventAction::GetHitStore(const G4String& sdName) const
 {
-  auto hitsCollection 
-    = static_cast<DUTHitsCollection*>(
-        event->GetHCofThisEvent()->GetHC(hcID));
+  auto sd = G4SDManager::GetSDMpointer()->FindSensitiveDetector(sdName, false);
   
-  if ( ! hitsCollection ) {
+  if ( ! sd ) {
     G4ExceptionDescription msg;
-    msg << "Cannot access hitsCollection ID " << hcID; 
-    G4Exception("EventAction::GetHitsCollection()",
+    msg << "Cannot access sensitive detector " << sdName; 
+    G4Exception("EventAction::GetHitStore()",
       "MyCode0003", FatalException, msg);
   }         
 
-  return hitsCollection;
+  if ( auto fitpix = dynamic_cast<FitpixSD*>(sd) ) return fitpix->GetHitStore();
+  return static_cast<DUTSD*>(sd)->GetHitStore();
 }  
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -89,6 +96,8 @@ void EventAction::PrintEventStatistics(G4double dutEdep, G4double dutTrackLength
   G4cout
      << "   DUT: total energy: " 
      << std::setw(7) << G4BestUnit(dutEdep, "Energy")
+     << "       total track length: " 
+     << std::setw(7) << G4BestUnit(dutTrackLength, "Length")
      << G4endl;
 }
 
@@ -101,45 +110,50 @@ void EventAction::BeginOfEventAction( const G4Event* event)
 
 void EventAction::EndOfEventAction(const G4Event* event)
 {                          
-  auto primPart = event->GetPrimaryVertex()->GetPrimary();
-  auto primPart_energy = primPart->GetKineticEnergy();
-
-  // Get hits collections IDs (only once)
-  if ( fdutAHCID == -1 || fdutBHCID == -1  ) {
-    fdutAHCID = G4SDManager::GetSDMpointer()->GetCollectionID("DUTAHitsCollection");
-    fdutBHCID = G4SDManager::GetSDMpointer()->GetCollectionID("DUTBHitsCollection");
+  // Get the hit stores of the sensitive detectors (only once)
+  if ( ! fDutAStore ) {
+    fDutAStore = &GetHitStore("Sensor 110 um");
+    fDutBStore = &GetHitStore("Sensor 150 um");
+    fFitpixStore = &GetHitStore("Fitpix");
   }
 
-  // Get hits collections for the Fitpix SD (only once)
-  if( ffitpixHCID == -1 ){
-    ffitpixHCID = G4SDManager::GetSDMpointer()->GetCollectionID("FitpixHitsCollection");
-  }
+  // Collect the event content from the hit stores
+  fRecord.Clear();
+  fRecord.fEventID = event->GetEventID();
+  auto primaryVertex = event->GetPrimaryVertex();
+  if ( primaryVertex ) fRecord.fPrimaryEnergy = primaryVertex->GetPrimary()->GetKineticEnergy();
+  SensorKernels::FillSensorRecord(*fDutAStore, fRecord.fDutA, true);
+  SensorKernels::FillSensorRecord(*fDutBStore, fRecord.fDutB, true);
+  SensorKernels::FillSensorRecord(*fFitpixStore, fRecord.fFitpix, false);
 
-  // Get hits collections
-  auto dutAHC = GetHitsCollection(fdutAHCID, event);
-  auto dutBHC = GetHitsCollection(fdutBHCID, event);
-  auto fitpixHC = GetHitsCollection(ffitpixHCID, event); 
+  // Store it in the overlay library, or add the library entries drawn
+  // for this event
+  if ( fOverlay ) fOverlay->EndOfEvent(fRecord);
 
-  // Get hit with total values
-  auto dutAHitsAll = (*dutAHC)[dutAHC->entries()-1];
-  auto dutAHitsAllLarge = (*dutAHC)[dutAHC->entries()-3];
-  auto dutAHitsAllSmall = (*dutAHC)[dutAHC->entries()-2];
-  
-  auto dutBHitsAll = (*dutBHC)[dutBHC->entries()-1];
-  auto dutBHitsAllLarge = (*dutBHC)[dutBHC->entries()-3];
-  auto dutBHitsAllSmall = (*dutBHC)[dutBHC->entries()-2];
+  // A sub-event only contributes to its bunch: the output is filled by the
+  // thread completing it
+  auto subEvent = dynamic_cast<SubEventInformation*>(event->GetUserInformation());
+  if ( subEvent ) {
+    fRecord.fEventID = subEvent->GetBunchID();
+    if ( ! BunchAssembler::Instance()->Add(fRecord, subEvent->GetSubEvent(),
+                                           subEvent->GetNofSubEvents()) ) return;
+  }
+
+  FillOutputs(fRecord);
+}
 
-  //auto fitpixHit = (*fitpixHC)[0];
-  auto fitpixHitAll = (*fitpixHC)[fitpixHC->entries()-1];
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void EventAction::FillOutputs(const EventRecord& record) const
+{
   // Print per event (modulo n)
   //
-  auto eventID = event->GetEventID();
+  auto eventID = record.fEventID;
   auto printModulo = G4RunManager::GetRunManager()->GetPrintProgress();
   if ( ( printModulo > 0 ) && ( eventID % printModulo == 0 ) ) {
-    if(dutAHitsAll->GetEdep() > 0){
+    if(record.fDutA.fEdep > 0){
       G4cout << "---> End of event: " << eventID << G4endl;
-      PrintEventStatistics(dutAHitsAll->GetEdep(), dutAHitsAll->GetTrackLength());
+      PrintEventStatistics(record.fDutA.fEdep, record.fDutA.fTrackLength);
     }
   }  
   
@@ -148,119 +162,121 @@ void EventAction::EndOfEventAction(const G4Event* event)
   // get analysis manager
   auto analysisManager = G4AnalysisManager::Instance();
   // fill primary vertex histogram
-  analysisManager->FillH1(0, primPart_energy);
+  if(record.fPrimaryEnergy > 0) analysisManager->FillH1(0, record.fPrimaryEnergy);
   //
-  if(dutAHitsAll->GetEdep() > 0){  
-    // fill histograms
-    analysisManager->FillH1(1, dutAHitsAll->GetEdep());
-    analysisManager->FillH1(2, dutAHitsAll->GetEdep()/(27.0*CLHEP::eV)/1000.0);
-    //analysisManager->FillH1(3);
-    if(dutAHitsAllLarge->GetEdep() > 0) analysisManager->FillH1(4, dutAHitsAllLarge->GetEdep());
-    if(dutAHitsAllSmall->GetEdep() > 0) analysisManager->FillH1(5, dutAHitsAllSmall->GetEdep());
-    //
-    if(dutAHitsAllLarge->GetEdep() > 0){
-      analysisManager->FillNtupleIColumn(2, 0, eventID);
-      analysisManager->FillNtupleDColumn(2, 1, dutAHitsAllLarge->GetEdep());
-      analysisManager->FillNtupleSColumn(2, 3, "110um");
-      analysisManager->AddNtupleRow(2);
-    }
-    if(dutAHitsAllSmall->GetEdep() > 0){
-      analysisManager->FillNtupleIColumn(2, 0, eventID);
-      analysisManager->FillNtupleDColumn(2, 2, dutAHitsAllSmall->GetEdep());
-      analysisManager->FillNtupleSColumn(2, 3, "110um");
-      analysisManager->AddNtupleRow(2);
-    }
-    //
-    analysisManager->FillNtupleIColumn(1, 0, eventID);
-    analysisManager->FillNtupleDColumn(1, 1, dutAHitsAll->GetEdep()/CLHEP::keV);
-    analysisManager->FillNtupleSColumn(1, 2, "110um");
-    analysisManager->AddNtupleRow(1);
+  // with the asynchronous output the record replaces the ntuple rows
+  auto writer = AsyncWriter::Instance();
+  auto fillNtuples = ! writer->IsActive();
+  if ( ! fillNtuples ) writer->Push(record);
+  //
+  FillDUTOutputs(record.fDutA, eventID, 1, 0, RunAction::kWafer110um, fillNtuples);
+  FillDUTOutputs(record.fDutB, eventID, 6, 1, RunAction::kWafer150um, fillNtuples);
+  if(fillNtuples && fRunAction->GetEventSchema()) FillDUTEventRow(record);
 
+  if(record.fFitpix.fEdep > 0){
     // fill ntuple
-    for(size_t i=0; i< dutAHC->entries()-1; i++){
-      auto dutHit = (*dutAHC)[i];
-      auto edep = dutHit->GetEdep()/CLHEP::keV;
-      if(edep == 0) continue;
-      
-      auto xpos = dutHit->GetX()/CLHEP::mm;
-      auto ypos = dutHit->GetY()/CLHEP::mm;
-      auto zpos = dutHit->GetZ()/CLHEP::mm;
-      //auto zpos = dutHit->GetZ();
-      analysisManager->FillH2(0, xpos, ypos, edep);
-      //
-      analysisManager->FillNtupleIColumn(0, 0, eventID);
-      analysisManager->FillNtupleIColumn(0, 1, i+1);
-      analysisManager->FillNtupleDColumn(0, 2, edep);
-      analysisManager->FillNtupleDColumn(0, 3, xpos);
-      analysisManager->FillNtupleDColumn(0, 4, ypos);
-      analysisManager->FillNtupleDColumn(0, 5, zpos);
-      analysisManager->FillNtupleSColumn(0, 6, "110um");
-      analysisManager->AddNtupleRow(0);
+    for(const auto& deposit : record.fFitpix.fLayers){
+      auto edep = deposit.fEdep/CLHEP::keV;
+      analysisManager->FillH2(2, deposit.fPos.x(), deposit.fPos.y(), edep);
     }
   }
+}
 
-  if(dutBHitsAll->GetEdep() > 0){  
-    // fill histograms
-    analysisManager->FillH1(6, dutBHitsAll->GetEdep());
-    analysisManager->FillH1(7, dutBHitsAll->GetEdep()/(27.0*CLHEP::eV)/1000.0);
-    //analysisManager->FillH1(8);
-    if(dutBHitsAllLarge->GetEdep() > 0) analysisManager->FillH1(9, dutBHitsAllLarge->GetEdep());
-    if(dutBHitsAllSmall->GetEdep() > 0) analysisManager->FillH1(10, dutBHitsAllSmall->GetEdep());
-    //
-    if(dutBHitsAllLarge->GetEdep() > 0){
-      analysisManager->FillNtupleIColumn(2, 0, eventID);
-      analysisManager->FillNtupleDColumn(2, 1, dutBHitsAllLarge->GetEdep());
-      analysisManager->FillNtupleSColumn(2, 3, "150um");
-      analysisManager->AddNtupleRow(2);
-    }
-    if(dutBHitsAllSmall->GetEdep() > 0){
-      analysisManager->FillNtupleIColumn(2, 0, eventID);
-      analysisManager->FillNtupleDColumn(2, 2, dutBHitsAllSmall->GetEdep());
-      analysisManager->FillNtupleSColumn(2, 3, "150um");
-      analysisManager->AddNtupleRow(2);
-    }
-    //
-    analysisManager->FillNtupleIColumn(1, 0, eventID);
-    analysisManager->FillNtupleDColumn(1, 1, dutBHitsAll->GetEdep()/CLHEP::keV);
-    analysisManager->FillNtupleSColumn(1, 2, "150um");
-    analysisManager->AddNtupleRow(1);
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-    // fill ntuple
-    for(size_t i=0; i< dutBHC->entries()-1; i++){
-      auto dutHit = (*dutBHC)[i];
-      auto edep = dutHit->GetEdep()/CLHEP::keV;
-      if(edep == 0) continue;
-      
-      auto xpos = dutHit->GetX();
-      auto ypos = dutHit->GetY();
-      auto zpos = dutHit->GetZ();
-      analysisManager->FillH2(1, xpos, ypos, edep);
-      //
-      analysisManager->FillNtupleIColumn(0, 0, eventID);
-      analysisManager->FillNtupleIColumn(0, 1, i+1);
-      analysisManager->FillNtupleDColumn(0, 2, edep);
-      analysisManager->FillNtupleDColumn(0, 3, xpos/CLHEP::mm);
-      analysisManager->FillNtupleDColumn(0, 4, ypos/CLHEP::mm);
-      analysisManager->FillNtupleDColumn(0, 5, zpos/CLHEP::mm);
-      analysisManager->FillNtupleSColumn(0, 6, "150um");
-      analysisManager->AddNtupleRow(0);
+void EventAction::FillDUTOutputs(const SensorRecord& dut, G4int eventID,
+                                 G4int firstH1, G4int h2, G4int waferID,
+                                 G4bool fillNtuples) const
+{
+  if(dut.fEdep <= 0) return;
+  const char* wafer = (waferID == RunAction::kWafer110um) ? "110um" : "150um";
+
+  auto analysisManager = G4AnalysisManager::Instance();
+  // fill histograms: edepTot, charge, (primary is filled by the SD), edepTotLarge, edepTotSmall
+  analysisManager->FillH1(firstH1, dut.fEdep);
+  analysisManager->FillH1(firstH1+1, dut.fEdep/(27.0*CLHEP::eV)/1000.0);
+  if(dut.fEdepLarge > 0) analysisManager->FillH1(firstH1+3, dut.fEdepLarge);
+  if(dut.fEdepSmall > 0) analysisManager->FillH1(firstH1+4, dut.fEdepSmall);
+  //
+  if(fillNtuples){
+    for(G4int pad = 0; pad < PadLayout::kNofPads; ++pad){
+      if(dut.fPadEdep[pad] <= 0) continue;
+      analysisManager->FillNtupleIColumn(4, 0, eventID);
+      analysisManager->FillNtupleIColumn(4, 1, waferID);
+      analysisManager->FillNtupleIColumn(4, 2, pad);
+      analysisManager->FillNtupleDColumn(4, 3, dut.fPadEdep[pad]/CLHEP::keV);
+      analysisManager->FillNtupleDColumn(4, 4, dut.fPadEdep[pad]/(27.0*CLHEP::eV)/1000.0);
+      analysisManager->AddNtupleRow(4);
     }
   }
-
-  if(fitpixHitAll->GetEdep() > 0){
-    // fill ntuple
-    for(size_t i=0; i< fitpixHC->entries()-1; i++){
-      auto fitpixHit = (*fitpixHC)[i];
-      auto edep = fitpixHit->GetEdep()/CLHEP::keV;
-      if(edep == 0) continue;
-      
-      auto xpos = fitpixHit->GetX();
-      auto ypos = fitpixHit->GetY();
-      auto zpos = fitpixHit->GetZ();
-      analysisManager->FillH2(2, xpos, ypos, edep);
+  // the event-wise row takes both wafers, see FillDUTEventRow()
+  if(fRunAction->GetEventSchema()) fillNtuples = false;
+  if(! fillNtuples){
+    for(const auto& deposit : dut.fLayers){
+      analysisManager->FillH2(h2, deposit.fPos.x()/CLHEP::mm, deposit.fPos.y()/CLHEP::mm,
+                              deposit.fEdep/CLHEP::keV);
     }
+    return;
+  }
+  //
+  if(dut.fEdepLarge > 0){
+    analysisManager->FillNtupleIColumn(2, 0, eventID);
+    analysisManager->FillNtupleDColumn(2, 1, dut.fEdepLarge);
+    analysisManager->FillNtupleSColumn(2, 3, wafer);
+    analysisManager->AddNtupleRow(2);
+  }
+  if(dut.fEdepSmall > 0){
+    analysisManager->FillNtupleIColumn(2, 0, eventID);
+    analysisManager->FillNtupleDColumn(2, 2, dut.fEdepSmall);
+    analysisManager->FillNtupleSColumn(2, 3, wafer);
+    analysisManager->AddNtupleRow(2);
+  }
+  //
+  analysisManager->FillNtupleIColumn(1, 0, eventID);
+  analysisManager->FillNtupleDColumn(1, 1, dut.fEdep/CLHEP::keV);
+  analysisManager->FillNtupleSColumn(1, 2, wafer);
+  analysisManager->AddNtupleRow(1);
+
+  // fill ntuple
+  for(const auto& deposit : dut.fLayers){
+    auto edep = deposit.fEdep/CLHEP::keV;
+    auto xpos = deposit.fPos.x()/CLHEP::mm;
+    auto ypos = deposit.fPos.y()/CLHEP::mm;
+    auto zpos = deposit.fPos.z()/CLHEP::mm;
+    analysisManager->FillH2(h2, xpos, ypos, edep);
+    //
+    analysisManager->FillNtupleIColumn(0, 0, eventID);
+    analysisManager->FillNtupleIColumn(0, 1, deposit.fLayer+1);
+    analysisManager->FillNtupleDColumn(0, 2, edep);
+    analysisManager->FillNtupleDColumn(0, 3, xpos);
+    analysisManager->FillNtupleDColumn(0, 4, ypos);
+    analysisManager->FillNtupleDColumn(0, 5, zpos);
+    analysisManager->FillNtupleSColumn(0, 6, wafer);
+    analysisManager->AddNtupleRow(0);
   }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void EventAction::FillDUTEventRow(const EventRecord& record) const
+{
+  if(record.fDutA.fEdep <= 0 && record.fDutB.fEdep <= 0) return;
+
+  auto analysisManager = G4AnalysisManager::Instance();
+  analysisManager->FillNtupleIColumn(3, 0, record.fEventID);
+  const SensorRecord* duts[RunAction::kNofWafers] = { &record.fDutA, &record.fDutB };
+  for(G4int wafer = 0; wafer < RunAction::kNofWafers; ++wafer){
+    const auto& dut = *duts[wafer];
+    // Layers without deposit stay at zero; the pad sums have their own columns
+    SensorKernels::FillLayerColumns(dut, fRunAction->GetLayerEdep(wafer), fRunAction->GetLayerPosX(wafer),
+                                    fRunAction->GetLayerPosY(wafer), fRunAction->GetLayerPosZ(wafer));
+    // the vector columns follow the three totals of the wafer
+    G4int firstColumn = 1 + 7*wafer;
+    analysisManager->FillNtupleDColumn(3, firstColumn, dut.fEdep/CLHEP::keV);
+    analysisManager->FillNtupleDColumn(3, firstColumn+1, dut.fEdepLarge/CLHEP::keV);
+    analysisManager->FillNtupleDColumn(3, firstColumn+2, dut.fEdepSmall/CLHEP::keV);
+  }
+  analysisManager->AddNtupleRow(3);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,70 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EventRecord.cc
+/// \brief Implementation of the EventRecord class
+
+#include "EventRecord.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SensorRecord::Add(const SensorRecord& other)
+{
+  fEdep      += other.fEdep;
+  fTrackLength += other.fTrackLength;
+  fEdepLarge += other.fEdepLarge;
+  fEdepSmall += other.fEdepSmall;
+  fNofLayers = std::max(fNofLayers, other.fNofLayers);
+  for ( std::size_t pad = 0; pad < fPadEdep.size(); ++pad ) fPadEdep[pad] += other.fPadEdep[pad];
+  if ( other.fLayers.empty() ) return;
+  if ( fLayers.empty() ) {
+    fLayers = other.fLayers;
+    return;
+  }
+
+  // merge the two ordered layer lists
+  std::vector<LayerDeposit> merged;
+  merged.reserve(fLayers.size() + other.fLayers.size());
+  auto it = fLayers.begin();
+  auto ot = other.fLayers.begin();
+  while ( it != fLayers.end() || ot != other.fLayers.end() ) {
+    if ( ot == other.fLayers.end() || (it != fLayers.end() && it->fLayer < ot->fLayer) ) {
+      merged.push_back(*it++);
+    }
+    else if ( it == fLayers.end() || ot->fLayer < it->fLayer ) {
+      merged.push_back(*ot++);
+    }
+    else {
+      merged.push_back({it->fLayer, it->fEdep + ot->fEdep, it->fPos + ot->fPos});
+      ++it;
+      ++ot;
+    }
+  }
+  fLayers.swap(merged);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,167 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EventSeeder.cc
+/// \brief Implementation of the EventSeeder class
+
+#include "EventSeeder.hh"
+#include "SeedMessenger.hh"
+
+#include "Analysis.hh"
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommand.hh"
+#include "Randomize.hh"
+
+#include <cstdint>
+
+namespace {
+    // Set by the master at the start of the run, read by the workers
+    // during the event loop
+    G4long runSeed = 0;
+    G4long fixedRunSeed = 0;
+    G4long drawnBaseSeed = 0;
+    G4long replaySeed = 0;
+    std::vector<G4int> replayEventIDs;
+
+    // Seed of a run from (base seed, run ID): SplitMix64 finaliser, kept
+    // positive and below 2^31 like the seeds drawn from the engine
+    G4long RunSeed(G4long baseSeed, G4int runID)
+    {
+        std::uint64_t z = std::uint64_t(baseSeed) + 0x9e3779b97f4a7c15ULL*(std::uint64_t(runID) + 1);
+        z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+        z ^= z >> 31;
+        return 1 + G4long(z % 2147483646ULL);
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventSeeder::EventSeeder()
+ : fMessenger(0)
+{
+  fMessenger = new SeedMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventSeeder::~EventSeeder()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventSeeder::SetRunSeed(G4long seed)
+{
+  fixedRunSeed = seed;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventSeeder::Replay(G4long seed, const std::vector<G4int>& eventIDs)
+{
+  if (eventIDs.empty()) {
+    G4Exception("EventSeeder::Replay()", "MyCode0027", JustWarning,
+                "No event ID to replay");
+    return;
+  }
+  // One event loop thread, so that the events are processed one after the
+  // other in the order of the list (the chunks of the MT and tasking run
+  // managers are capped and spread over the threads)
+  G4int nofThreads = G4RunManager::GetRunManager()->GetNumberOfThreads();
+  if (nofThreads > 1) {
+    G4ExceptionDescription msg;
+    msg << "Replay refused with " << nofThreads << " threads:" << G4endl
+        << "start the job with -t 1 or -r serial.";
+    G4Exception("EventSeeder::Replay()", "MyCode0027", JustWarning, msg);
+    return;
+  }
+  replaySeed = seed;
+  replayEventIDs = eventIDs;
+
+  // The replay does not overwrite the output of the job: <name>_replay,
+  // then back to the file name in force (dutOut.root when none is set)
+  auto uiManager = G4UImanager::GetUIpointer();
+  G4String fileName = G4AnalysisManager::Instance()->GetFileName();
+  if (fileName.empty()) fileName = "dutOut.root";
+  G4String baseName = fileName;
+  if (baseName.size() > 5 && baseName.substr(baseName.size() - 5) == ".root") {
+    baseName.erase(baseName.size() - 5);
+  }
+  uiManager->ApplyCommand("/analysis/setFileName " + baseName + "_replay");
+  uiManager->ApplyCommand("/run/beamOn " + G4UIcommand::ConvertToString(G4int(eventIDs.size())));
+  uiManager->ApplyCommand("/analysis/setFileName " + fileName);
+
+  replayEventIDs.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventSeeder::BeginOfRun(G4int runID)
+{
+  if (IsReplaying()) {
+    runSeed = replaySeed;
+  }
+  else {
+    // The base seed is drawn once: the engine of the master is not in the
+    // same state at the next runs with all the run managers (the serial one
+    // reseeds it at each event)
+    G4long baseSeed = fixedRunSeed;
+    if (baseSeed == 0) {
+      if (drawnBaseSeed == 0) drawnBaseSeed = 1 + G4long(100000000L*G4UniformRand());
+      baseSeed = drawnBaseSeed;
+    }
+    runSeed = RunSeed(baseSeed, runID);
+  }
+  G4cout << "---> Run seed: " << runSeed;
+  if (IsReplaying()) G4cout << " (replay of " << replayEventIDs.size() << " events)";
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EventSeeder::IsReplaying()
+{
+  return ! replayEventIDs.empty();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EventSeeder::ReplayedEventID(G4int i)
+{
+  return replayEventIDs[i];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventSeeder::SeedEvent(G4int eventID)
+{
+  // No zero seed: the list ends with the first one
+  long seeds[3] = { long(runSeed), long(eventID) + 1, 0 };
+  G4Random::setTheSeeds(seeds, -1);
+}
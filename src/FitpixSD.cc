@@ -28,6 +28,7 @@
 /// \brief Implementation of the FitpixSD class
 
 #include "FitpixSD.hh"
+#include "SensorKernels.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4Step.hh"
 #include "G4ThreeVector.hh"
@@ -43,13 +44,13 @@
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-FitpixSD::FitpixSD(const G4String& name, const G4String& hitsCollectionName, G4int nofLayers)
+FitpixSD::FitpixSD(const G4String& name, G4int nofLayers,
+                   G4double virtualThickness)
  : G4VSensitiveDetector(name),
-   fHitsCollection(nullptr),
-   fNofLayers(nofLayers)
-{
-  collectionName.insert(hitsCollectionName);
-}
+   fHitStore(nofLayers),
+   fNofLayers(nofLayers),
+   fSlicer(nofLayers, virtualThickness)
+{}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -58,20 +59,10 @@ FitpixSD::~FitpixSD(){
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void FitpixSD::Initialize(G4HCofThisEvent* hce)
+void FitpixSD::Initialize(G4HCofThisEvent*)
 {
-  // Create hits collection
-  fHitsCollection = new DUTHitsCollection(SensitiveDetectorName, collectionName[0]); 
-
-  // Add this collection in hce
-  auto hcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
-  hce->AddHitsCollection( hcID, fHitsCollection ); 
-
-  // Create hits
-  // fNofLayers for cells + one more for total sums 
-  for (G4int i=0; i<fNofLayers+1; i++ ) {
-    fHitsCollection->insert(new DUTHit());
-  }
+  // Zero the layers hit in the previous event
+  fHitStore.Clear();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -89,29 +80,37 @@ G4bool FitpixSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 
   if ( edep==0. && stepLength == 0. ) return false;      
 
-  G4ThreeVector edepPos = ( step->GetPostStepPoint()->GetPosition() + step->GetPreStepPoint()->GetPosition() ) / 2;
+  SensorStep sensorStep;
+  sensorStep.fEdep = edep;
+  sensorStep.fStepLength = stepLength;
+  sensorStep.fPrePos = step->GetPreStepPoint()->GetPosition();
+  sensorStep.fPostPos = step->GetPostStepPoint()->GetPosition();
 
   auto touchable = (step->GetPreStepPoint()->GetTouchable());  
   // Get sensor layer id 
-  auto layerNumber = touchable->GetCopyNumber(0);
+  if ( fSlicer.IsActive() ) {
+    // Single solid sensor: the layer follows from the local depth
+    const auto& toLocal = touchable->GetHistory()->GetTopTransform();
+    sensorStep.fLocalPre = toLocal.TransformPoint(sensorStep.fPrePos);
+    sensorStep.fLocalPost = toLocal.TransformPoint(sensorStep.fPostPos);
+    sensorStep.fLayer = fSlicer.LayerOf(sensorStep.fLocalPre.z());
+  }
+  else {
+    sensorStep.fLayer = touchable->GetCopyNumber(0);
+  }
+  G4int layerNumber = sensorStep.fLayer;
   //G4cout << "Layer number: " << layerNumber << G4endl;
 
 
-  // Get hit accounting data for this layer
-  auto hit = (*fHitsCollection)[layerNumber];
-  if ( ! hit ) {
+  if ( layerNumber < 0 || layerNumber >= fNofLayers ) {
     G4ExceptionDescription msg;
-    msg << "Cannot access hit " << layerNumber; 
+    msg << "Layer " << layerNumber << " out of range"; 
     G4Exception("FitpixSD::ProcessHits()",
       "MyCode0004", FatalException, msg);
   }         
 
-  // Get hit for total accounting
-  auto hitTotal = (*fHitsCollection)[fHitsCollection->entries()-1];
-
   // Add values
-  hit->Add(edep, edepPos);
-  hitTotal->Add(edep);
+  SensorKernels::AddLayers(fHitStore, fSlicer, sensorStep);
   
   return true;
 }
@@ -121,12 +120,10 @@ G4bool FitpixSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 void FitpixSD::EndOfEvent(G4HCofThisEvent*)
 {
   if ( verboseLevel>1 ) { 
-     auto nofHits = fHitsCollection->entries();
      G4cout
        << G4endl 
-       << "-------->Hits Collection: in this event they are " << nofHits 
-       << " hits in the tracker chambers: " << G4endl;
-     for ( std::size_t i=0; i<nofHits; ++i ) (*fHitsCollection)[i]->Print();
+       << "-------->Hit store of " << SensitiveDetectorName << ":" << G4endl;
+     fHitStore.Print();
   }
 }
 
@@ -0,0 +1,228 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file OverlayEngine.cc
+/// \brief Implementation of the OverlayEngine class
+
+#include "OverlayEngine.hh"
+#include "OverlayMessenger.hh"
+#include "BinaryIO.hh"
+
+#include "G4AutoLock.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <map>
+
+namespace {
+  G4Mutex loadMutex = G4MUTEX_INITIALIZER;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OverlayEngine::OverlayEngine()
+ : fMessenger(nullptr)
+{
+  fMessenger = new OverlayMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OverlayEngine::~OverlayEngine()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayEngine::SetLibraryToBuild(const G4String& fileName)
+{
+  if ( fFile.is_open() ) fFile.close();
+  if ( fileName.empty() ) return;
+
+  auto threadFileName = ThreadFileName(fileName);
+  fFile.open(threadFileName, std::ios::binary | std::ios::trunc);
+  if ( ! fFile ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open overlay library " << threadFileName; 
+    G4Exception("OverlayEngine::SetLibraryToBuild()",
+      "MyCode0014", FatalException, msg);
+  }
+  WriteBinaryHeader(fFile, kOverlayMagic, kOverlayVersion, sizeof(OverlayRecord));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayEngine::SetLibraryToUse(const G4String& fileName)
+{
+  fLibrary.reset();
+  if ( fileName.empty() ) return;
+  fLibrary = Load(fileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::shared_ptr<const OverlayEngine::Library> OverlayEngine::Load(const G4String& fileName)
+{
+  // The workers share one copy of each library
+  G4AutoLock lock(&loadMutex);
+  static std::map<G4String, std::weak_ptr<const Library>> cache;
+  auto library = cache[fileName].lock();
+  if ( library ) return library;
+
+  auto newLibrary = std::make_shared<Library>();
+  auto nofFiles = ReadBinaryShards(fileName, kOverlayMagic, kOverlayVersion, newLibrary->records);
+  // The rows of one entry are contiguous in a shard
+  for ( std::size_t i = 0; i < newLibrary->records.size(); ++i ) {
+    if ( i == 0 || newLibrary->records[i].entry != newLibrary->records[i-1].entry ) {
+      newLibrary->entryStart.push_back(i);
+    }
+  }
+  if ( newLibrary->entryStart.empty() ) {
+    G4ExceptionDescription msg;
+    msg << "No entries found in overlay library " << fileName << "(.t*)"; 
+    G4Exception("OverlayEngine::Load()",
+      "MyCode0015", FatalException, msg);
+  }
+  G4cout << "---> Overlay library " << fileName << ": "
+         << newLibrary->entryStart.size() << " single-primary events from "
+         << nofFiles << " file(s)" << G4endl;
+
+  cache[fileName] = newLibrary;
+  return newLibrary;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayEngine::Draw(G4int multiplicity)
+{
+  fDrawn.clear();
+  auto nofEntries = fLibrary->entryStart.size();
+  for ( G4int i = 0; i < multiplicity; ++i ) {
+    auto entry = std::size_t(G4UniformRand()*nofEntries);
+    fDrawn.push_back(std::min(entry, nofEntries-1));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayEngine::EndOfEvent(EventRecord& record)
+{
+  if ( IsBuilding() ) Write(record);
+  if ( IsOverlaying() ) AddEntries(record);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayEngine::Write(const EventRecord& record)
+{
+  std::vector<OverlayRecord> rows;
+  AppendRows(record, rows);
+  fFile.write(reinterpret_cast<const char*>(rows.data()), rows.size()*sizeof(OverlayRecord));
+  fFile.flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayEngine::AppendRows(const EventRecord& record, std::vector<OverlayRecord>& rows)
+{
+  rows.push_back({record.fEventID, kEvent, 0, float(record.fPrimaryEnergy), 0.f, 0.f, 0.f});
+
+  const SensorRecord* sensors[3] = { &record.fDutA, &record.fDutB, &record.fFitpix };
+  for ( std::int16_t sensor = 0; sensor < 3; ++sensor ) {
+    const auto& sensorRecord = *sensors[sensor];
+    if ( sensorRecord.fEdep == 0. && sensorRecord.fTrackLength == 0. ) continue;
+    rows.push_back({record.fEventID, sensor, kTotal, float(sensorRecord.fEdep),
+                    float(sensorRecord.fTrackLength), 0.f, 0.f});
+    if ( sensorRecord.fEdepLarge != 0. ) {
+      rows.push_back({record.fEventID, sensor, kLarge, float(sensorRecord.fEdepLarge), 0.f, 0.f, 0.f});
+    }
+    if ( sensorRecord.fEdepSmall != 0. ) {
+      rows.push_back({record.fEventID, sensor, kSmall, float(sensorRecord.fEdepSmall), 0.f, 0.f, 0.f});
+    }
+    for ( G4int pad = 0; pad < PadLayout::kNofPads; ++pad ) {
+      if ( sensorRecord.fPadEdep[pad] == 0. ) continue;
+      rows.push_back({record.fEventID, sensor, std::int16_t(kPad - pad),
+                      float(sensorRecord.fPadEdep[pad]), 0.f, 0.f, 0.f});
+    }
+    for ( const auto& deposit : sensorRecord.fLayers ) {
+      rows.push_back({record.fEventID, sensor, std::int16_t(deposit.fLayer), float(deposit.fEdep),
+                      float(deposit.fPos.x()), float(deposit.fPos.y()), float(deposit.fPos.z())});
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayEngine::AddEntries(EventRecord& record)
+{
+  SensorRecord* sensors[3] = { &record.fDutA, &record.fDutB, &record.fFitpix };
+  SensorRecord drawn[3];
+
+  for ( auto entry : fDrawn ) {
+    auto first = fLibrary->entryStart[entry];
+    auto last = (entry+1 < fLibrary->entryStart.size()) ? fLibrary->entryStart[entry+1]
+                                                        : fLibrary->records.size();
+    for ( auto i = first; i < last; ++i ) {
+      const auto& row = fLibrary->records[i];
+      if ( row.sensor == kEvent ) {
+        if ( record.fPrimaryEnergy == 0. ) record.fPrimaryEnergy = row.edep;
+        continue;
+      }
+      auto& sum = fSums[row.sensor];
+      if      ( row.layer == kTotal ) {
+        drawn[row.sensor].fEdep += row.edep;
+        drawn[row.sensor].fTrackLength += row.x;
+      }
+      else if ( row.layer == kLarge ) drawn[row.sensor].fEdepLarge += row.edep;
+      else if ( row.layer == kSmall ) drawn[row.sensor].fEdepSmall += row.edep;
+      else if ( row.layer <= kPad ) drawn[row.sensor].fPadEdep[kPad - row.layer] += row.edep;
+      else {
+        if ( std::size_t(row.layer) >= sum.edep.size() ) {
+          sum.edep.resize(row.layer+1, 0.);
+          sum.pos.resize(row.layer+1);
+        }
+        if ( sum.edep[row.layer] == 0. ) sum.touched.push_back(row.layer);
+        sum.edep[row.layer] += row.edep;
+        sum.pos[row.layer] += G4ThreeVector(row.x, row.y, row.z);
+      }
+    }
+  }
+
+  // Move the dense sums to the records and reset the touched layers only
+  for ( G4int sensor = 0; sensor < 3; ++sensor ) {
+    auto& sum = fSums[sensor];
+    std::sort(sum.touched.begin(), sum.touched.end());
+    for ( auto layer : sum.touched ) {
+      drawn[sensor].fLayers.push_back({layer, sum.edep[layer], sum.pos[layer]});
+      sum.edep[layer] = 0.;
+      sum.pos[layer] = G4ThreeVector();
+    }
+    sum.touched.clear();
+    sensors[sensor]->Add(drawn[sensor]);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,86 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file OverlayMessenger.cc
+/// \brief Implementation of the OverlayMessenger class
+//
+//
+//
+// 
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "OverlayMessenger.hh"
+#include "OverlayEngine.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+
+
+
+OverlayMessenger::OverlayMessenger(OverlayEngine* overlay)
+ :G4UImessenger(),
+  fOverlay(overlay),
+  fOverlayDir(0),
+  fBuildCmd(0),
+  fUseCmd(0)
+{
+  fOverlayDir = new G4UIdirectory("/btf/overlay/");
+  fOverlayDir->SetGuidance("Pile-up by overlay of single-primary events");
+
+  fBuildCmd = new G4UIcmdWithAString("/btf/overlay/buildLibrary",this);
+  fBuildCmd->SetGuidance("write the sensor content of each event to an overlay library file");
+  fBuildCmd->SetGuidance("(one file per worker thread). Run with multiplicity 1.");
+  fBuildCmd->SetGuidance("Without argument, stop writing.");
+  fBuildCmd->SetParameterName("fileName", true);
+  fBuildCmd->SetDefaultValue("");
+  fBuildCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fUseCmd = new G4UIcmdWithAString("/btf/overlay/useLibrary",this);
+  fUseCmd->SetGuidance("make the events by summing randomly drawn library entries, one per");
+  fUseCmd->SetGuidance("beam particle, instead of transporting the beam (see /btf/gun/).");
+  fUseCmd->SetGuidance("Without argument, go back to the full simulation.");
+  fUseCmd->SetParameterName("fileName", true);
+  fUseCmd->SetDefaultValue("");
+  fUseCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+
+
+OverlayMessenger::~OverlayMessenger()
+{
+  delete fOverlayDir;
+  delete fBuildCmd;
+  delete fUseCmd;
+}
+
+
+
+void OverlayMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fBuildCmd) fOverlay->SetLibraryToBuild(newValue);
+  if (command == fUseCmd) fOverlay->SetLibraryToUse(newValue);
+}
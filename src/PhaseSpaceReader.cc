@@ -0,0 +1,152 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm4/src/PhaseSpaceReader.cc
+/// \brief Implementation of the PhaseSpaceReader class
+
+#include "PhaseSpaceReader.hh"
+#include "BinaryIO.hh"
+
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4ParticleTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4AutoLock.hh"
+
+#include <map>
+
+namespace {
+  G4Mutex loadMutex = G4MUTEX_INITIALIZER;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceReader::PhaseSpaceReader(const G4String& fileName)
+  : G4VPrimaryGenerator(),
+  fData(Load(fileName))
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceReader::~PhaseSpaceReader()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::shared_ptr<const PhaseSpaceReader::Data> PhaseSpaceReader::Load(const G4String& fileName)
+{
+  // The workers share one copy of each file
+  G4AutoLock lock(&loadMutex);
+  static std::map<G4String, std::weak_ptr<const Data>> cache;
+  auto data = cache[fileName].lock();
+  if ( data ) return data;
+
+  auto newData = std::make_shared<Data>();
+  auto nofFiles = ReadBinaryShards(fileName, kPhaseSpaceMagic, kPhaseSpaceVersion, newData->records);
+  // The records of one recorded event are contiguous in a shard
+  const auto& records = newData->records;
+  std::size_t nofParticles = 0;
+  for ( std::size_t i = 0; i < records.size(); ++i ) {
+    if ( records[i].pdg != 0 ) ++nofParticles;
+    if ( i > 0 && records[i].event == records[i-1].event ) continue;
+    auto id = std::size_t(records[i].event);
+    if ( id >= newData->groupStart.size() ) {
+      newData->groupStart.resize(id + 1, kNoGroup);
+      newData->groupEnd.resize(id + 1, kNoGroup);
+    }
+    if ( newData->groupStart[id] != kNoGroup ) {
+      G4ExceptionDescription msg;
+      msg << "Event " << id << " recorded twice in " << fileName
+          << "(.t*): one recording run per file";
+      G4Exception("PhaseSpaceReader::Load()",
+        "MyCode0012", FatalException, msg);
+    }
+    auto last = i + 1;
+    while ( last < records.size() && records[last].event == records[i].event ) ++last;
+    newData->groupStart[id] = i;
+    newData->groupEnd[id] = last;
+    ++newData->nofGroups;
+  }
+  if ( newData->nofGroups == 0 ) {
+    G4ExceptionDescription msg;
+    msg << "No phase-space records found in " << fileName << "(.t*)"; 
+    G4Exception("PhaseSpaceReader::Load()",
+      "MyCode0012", FatalException, msg);
+  }
+  G4cout << "---> Phase space " << fileName << ": " << nofParticles
+         << " particles in " << newData->nofGroups << " events (IDs up to "
+         << newData->groupStart.size()-1 << ") from " << nofFiles << " file(s)" << G4endl;
+
+  cache[fileName] = newData;
+  return newData;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceReader::GeneratePrimaryVertex(G4Event* event)
+{
+  GenerateGroup(event, event->GetEventID());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceReader::GenerateGroup(G4Event* event, std::size_t group) const
+{
+  // Reusing recorded events would bias the replay: stop instead
+  if ( group >= fData->groupStart.size() || fData->groupStart[group] == kNoGroup ) {
+    G4ExceptionDescription msg;
+    msg << "Recorded event " << group << " is not in the phase space ("
+        << fData->nofGroups << " events, IDs up to " << fData->groupStart.size()-1
+        << "): the replay needs a longer recording";
+    G4Exception("PhaseSpaceReader::GenerateGroup()",
+      "MyCode0012", FatalException, msg);
+    return;
+  }
+  auto first = fData->groupStart[group];
+  auto last = fData->groupEnd[group];
+
+  auto particleTable = G4ParticleTable::GetParticleTable();
+  for ( auto i = first; i < last; ++i ) {
+    const auto& record = fData->records[i];
+    if ( record.pdg == 0 ) continue;   // empty event
+    auto definition = particleTable->FindParticle(record.pdg);
+    if ( ! definition ) {
+      G4ExceptionDescription msg;
+      msg << "Unknown PDG code " << record.pdg << " in phase space, particle skipped"; 
+      G4Exception("PhaseSpaceReader::GeneratePrimaryVertex()",
+        "MyCode0013", JustWarning, msg);
+      continue;
+    }
+    auto vertex = new G4PrimaryVertex(G4ThreeVector(record.x, record.y, record.z), record.time);
+    auto particle = new G4PrimaryParticle(definition);
+    particle->SetKineticEnergy(record.ekin);
+    particle->SetMomentumDirection(G4ThreeVector(record.dx, record.dy, record.dz).unit());
+    vertex->SetPrimary(particle);
+    event->AddPrimaryVertex(vertex);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
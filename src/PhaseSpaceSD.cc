@@ -0,0 +1,128 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceSD.cc
+/// \brief Implementation of the PhaseSpaceSD class
+
+#include "PhaseSpaceSD.hh"
+#include "BinaryIO.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4EventManager.hh"
+#include "G4Event.hh"
+#include "G4ios.hh"
+
+namespace {
+  const std::size_t kBufferSize = 8192;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceSD::PhaseSpaceSD(const G4String& name, const G4String& fileName)
+ : G4VSensitiveDetector(name),
+   fEventRecorded(false)
+{
+  auto threadFileName = ThreadFileName(fileName);
+  fFile.open(threadFileName, std::ios::binary | std::ios::trunc);
+  if ( ! fFile ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open phase-space file " << threadFileName; 
+    G4Exception("PhaseSpaceSD::PhaseSpaceSD()",
+      "MyCode0011", FatalException, msg);
+  }
+  WriteBinaryHeader(fFile, kPhaseSpaceMagic, kPhaseSpaceVersion, sizeof(PhaseSpaceRecord));
+  fBuffer.reserve(kBufferSize);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceSD::~PhaseSpaceSD(){
+  Flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceSD::Initialize(G4HCofThisEvent*)
+{
+  fEventRecorded = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhaseSpaceSD::ProcessHits(G4Step* step, G4TouchableHistory*)
+{
+  // Only particles entering the plane and moving downstream (-z)
+  auto preStepPoint = step->GetPreStepPoint();
+  if ( preStepPoint->GetStepStatus() != fGeomBoundary ) return false;
+  if ( preStepPoint->GetMomentumDirection().z() >= 0. ) return false;
+
+  auto track = step->GetTrack();
+  const auto& pos = preStepPoint->GetPosition();
+  const auto& dir = preStepPoint->GetMomentumDirection();
+
+  PhaseSpaceRecord record;
+  record.event = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+  record.pdg   = track->GetDefinition()->GetPDGEncoding();
+  record.x  = pos.x();  record.y  = pos.y();  record.z  = pos.z();
+  record.dx = dir.x();  record.dy = dir.y();  record.dz = dir.z();
+  record.ekin = preStepPoint->GetKineticEnergy();
+  record.time = preStepPoint->GetGlobalTime();
+  fBuffer.push_back(record);
+  fEventRecorded = true;
+  if ( fBuffer.size() >= kBufferSize ) Flush();
+
+  // The rest of the event is simulated at replay
+  track->SetTrackStatus(fStopAndKill);
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceSD::EndOfEvent(G4HCofThisEvent*)
+{
+  // Nothing reached the plane: the replay must still see this event
+  if ( fEventRecorded ) return;
+  PhaseSpaceRecord marker = {};
+  marker.event = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+  marker.pdg   = 0;
+  fBuffer.push_back(marker);
+  if ( fBuffer.size() >= kBufferSize ) Flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceSD::Flush()
+{
+  if ( fBuffer.empty() ) return;
+  fFile.write(reinterpret_cast<const char*>(fBuffer.data()),
+              fBuffer.size()*sizeof(PhaseSpaceRecord));
+  fFile.flush();
+  fBuffer.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,113 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm4/src/PhysicsList.cc
+/// \brief Implementation of the PhysicsList class
+//
+//
+//
+// 
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PhysicsList.hh"
+#include "PhysicsListMessenger.hh"
+
+#include "G4EmStandardPhysics.hh"
+#include "G4EmStandardPhysics_option3.hh"
+#include "G4EmStandardPhysics_option4.hh"
+#include "G4EmLivermorePhysics.hh"
+#include "G4DecayPhysics.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsList::PhysicsList(const G4String& emName)
+ : G4VModularPhysicsList(),
+   fEmName(emName),
+   fMessenger(0)
+{
+  fMessenger = new PhysicsListMessenger(this);
+  SetVerboseLevel(1);
+
+  auto emPhysics = MakeEmPhysics(emName);
+  if ( ! emPhysics ) {
+    G4ExceptionDescription msg;
+    msg << "Unknown EM physics " << emName
+        << " (emstandard, emstandard_opt3, emstandard_opt4, emlivermore)"; 
+    G4Exception("PhysicsList::PhysicsList()",
+      "MyCode0019", FatalException, msg);
+  }
+  RegisterPhysics(emPhysics);
+  RegisterPhysics(new G4DecayPhysics());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsList::~PhysicsList()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhysicsList::IsEmPhysicsName(const G4String& name)
+{
+  return name == "emstandard" || name == "emstandard_opt3"
+      || name == "emstandard_opt4" || name == "emlivermore";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VPhysicsConstructor* PhysicsList::MakeEmPhysics(const G4String& name) const
+{
+  if ( name == "emstandard" )      return new G4EmStandardPhysics();
+  if ( name == "emstandard_opt3" ) return new G4EmStandardPhysics_option3();
+  if ( name == "emstandard_opt4" ) return new G4EmStandardPhysics_option4();
+  if ( name == "emlivermore" )     return new G4EmLivermorePhysics();
+  return nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::AddPhysicsList(const G4String& name)
+{
+  if ( name == fEmName ) return;
+
+  auto emPhysics = MakeEmPhysics(name);
+  if ( ! emPhysics ) {
+    G4ExceptionDescription msg;
+    msg << "Unknown EM physics " << name << ", keeping " << fEmName; 
+    G4Exception("PhysicsList::AddPhysicsList()",
+      "MyCode0020", JustWarning, msg);
+    return;
+  }
+  // the EM constructors share the same type: this replaces the current one
+  ReplacePhysics(emPhysics);
+  fEmName = name;
+  G4cout << "PhysicsList::AddPhysicsList: <" << name << ">" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,73 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm4/src/PhysicsListMessenger.cc
+/// \brief Implementation of the PhysicsListMessenger class
+//
+//
+//
+// 
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PhysicsListMessenger.hh"
+#include "PhysicsList.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+
+
+
+PhysicsListMessenger::PhysicsListMessenger(PhysicsList* physicsList)
+ :G4UImessenger(),
+  fPhysicsList(physicsList),
+  fPhysDir(0),
+  fListCmd(0)
+{
+  fPhysDir = new G4UIdirectory("/btf/phys/");
+  fPhysDir->SetGuidance("BTF physics list control");
+
+  fListCmd = new G4UIcmdWithAString("/btf/phys/addPhysics",this);
+  fListCmd->SetGuidance("select the EM constructor of the EM-only physics list (TestEm4 -p)");
+  fListCmd->SetParameterName("name", false);
+  fListCmd->SetCandidates("emstandard emstandard_opt3 emstandard_opt4 emlivermore");
+  fListCmd->AvailableForStates(G4State_PreInit);
+}
+
+
+
+PhysicsListMessenger::~PhysicsListMessenger()
+{
+  delete fPhysDir;
+  delete fListCmd;
+}
+
+
+
+void PhysicsListMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fListCmd) fPhysicsList->AddPhysicsList(newValue);
+}
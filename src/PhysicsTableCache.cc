@@ -0,0 +1,199 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm4/src/PhysicsTableCache.cc
+/// \brief Implementation of the PhysicsTableCache class
+//
+//
+//
+// 
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PhysicsTableCache.hh"
+#include "PhysicsTableCacheMessenger.hh"
+
+#include "G4VModularPhysicsList.hh"
+#include "G4VPhysicsConstructor.hh"
+#include "G4StateManager.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Material.hh"
+#include "G4EmParameters.hh"
+#include "G4Threading.hh"
+#include "G4Version.hh"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsTableCache::PhysicsTableCache(G4VModularPhysicsList* physicsList)
+ : G4VStateDependent(),
+   fPhysicsList(physicsList),
+   fMessenger(0)
+{
+  fMessenger = new PhysicsTableCacheMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsTableCache::~PhysicsTableCache()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhysicsTableCache::Notify(G4ApplicationState requestedState)
+{
+  if ( fDirectory.empty() || ! G4Threading::IsMasterThread() ) return true;
+
+  auto currentState = G4StateManager::GetStateManager()->GetCurrentState();
+  if ( currentState == G4State_Idle && requestedState == G4State_Init ) {
+    // A run starts: the tables are (re)built next, if needed
+    auto description = Describe();
+    auto entry = EntryName(description);
+    fPendingEntry.clear();
+    if ( IsStored(entry, description) ) {
+      fPhysicsList->SetPhysicsTableRetrieved(entry);
+      G4cout << "---> Physics tables retrieved from " << entry << G4endl;
+    }
+    else {
+      fPhysicsList->ResetPhysicsTableRetrieved();
+      fPendingEntry = entry;
+      fPendingDescription = description;
+    }
+  }
+  else if ( currentState == G4State_Init && requestedState == G4State_Idle
+            && ! fPendingEntry.empty() ) {
+    // The tables of the run are built
+    Store(fPendingEntry, fPendingDescription);
+    fPendingEntry.clear();
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String PhysicsTableCache::Describe() const
+{
+  std::ostringstream out;
+  out << std::setprecision(10);
+  out << "geant4 " << G4Version << "\n";
+
+  out << "physics";
+  for ( G4int i = 0; fPhysicsList->GetPhysics(i); ++i ) {
+    out << " " << fPhysicsList->GetPhysics(i)->GetPhysicsName();
+  }
+  out << "\n";
+
+  auto cutsTable = G4ProductionCutsTable::GetProductionCutsTable();
+  out << "energy range " << cutsTable->GetLowEdgeEnergy() << " "
+      << cutsTable->GetHighEdgeEnergy() << "\n";
+  for ( auto region : *G4RegionStore::GetInstance() ) {
+    auto cuts = region->GetProductionCuts();
+    if ( ! cuts ) continue;
+    out << "cuts " << region->GetName();
+    for ( G4int i = 0; i < NumberOfG4CutIndex; ++i ) out << " " << cuts->GetProductionCut(i);
+    out << "\n";
+  }
+
+  for ( auto material : *G4Material::GetMaterialTable() ) {
+    out << "material " << material->GetName() << " " << material->GetDensity()
+        << " " << material->GetTemperature() << " " << material->GetPressure();
+    auto fractions = material->GetFractionVector();
+    for ( std::size_t i = 0; i < material->GetNumberOfElements(); ++i ) {
+      out << " " << material->GetElement(i)->GetZ() << ":" << fractions[i];
+    }
+    out << "\n";
+  }
+
+  // Binning, msc models, step functions... of the EM tables
+  G4EmParameters::Instance()->StreamInfo(out);
+  return out.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String PhysicsTableCache::EntryName(const G4String& description) const
+{
+  // FNV-1a hash of the description
+  std::uint64_t hash = 14695981039346656037ull;
+  for ( unsigned char c : description ) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  std::ostringstream name;
+  name << fDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return name.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhysicsTableCache::IsStored(const G4String& entry, const G4String& description) const
+{
+  // The entry is complete once renamed; the key guards against hash clashes
+  std::ifstream in(entry + "/key.txt");
+  if ( ! in ) return false;
+  std::ostringstream stored;
+  stored << in.rdbuf();
+  return stored.str() == description;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::Store(const G4String& entry, const G4String& description) const
+{
+  namespace fs = std::filesystem;
+  std::error_code error;
+  auto tmpDir = entry + ".tmp" + std::to_string(::getpid());
+  fs::create_directories(tmpDir, error);
+  if ( error || ! fPhysicsList->StorePhysicsTable(tmpDir) ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot store the physics tables in " << tmpDir; 
+    G4Exception("PhysicsTableCache::Store()",
+      "MyCode0021", JustWarning, msg);
+    fs::remove_all(tmpDir, error);
+    return;
+  }
+  std::ofstream(tmpDir + "/key.txt") << description;
+
+  // Another job may have stored the same entry meanwhile: keep that one
+  fs::rename(tmpDir, entry, error);
+  if ( error ) {
+    fs::remove_all(tmpDir, error);
+    return;
+  }
+  G4cout << "---> Physics tables stored in " << entry << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,70 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm4/src/PhysicsTableCacheMessenger.cc
+/// \brief Implementation of the PhysicsTableCacheMessenger class
+//
+//
+//
+// 
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PhysicsTableCacheMessenger.hh"
+#include "PhysicsTableCache.hh"
+
+#include "G4UIcmdWithAString.hh"
+
+
+
+PhysicsTableCacheMessenger::PhysicsTableCacheMessenger(PhysicsTableCache* cache)
+ :G4UImessenger(),
+  fCache(cache),
+  fDirectoryCmd(0)
+{
+  // the /btf/phys/ directory belongs to the PhysicsList messenger, when used
+  fDirectoryCmd = new G4UIcmdWithAString("/btf/phys/tableCache",this);
+  fDirectoryCmd->SetGuidance("keep the physics tables in the given directory: they are stored the first time");
+  fDirectoryCmd->SetGuidance("and retrieved afterwards, as long as the physics list, the production cuts,");
+  fDirectoryCmd->SetGuidance("the materials and the Geant4 version are the same. Without argument, no cache.");
+  fDirectoryCmd->SetParameterName("directory", true);
+  fDirectoryCmd->SetDefaultValue("");
+  fDirectoryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+
+
+PhysicsTableCacheMessenger::~PhysicsTableCacheMessenger()
+{
+  delete fDirectoryCmd;
+}
+
+
+
+void PhysicsTableCacheMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fDirectoryCmd) fCache->SetDirectory(newValue);
+}
@@ -35,18 +35,28 @@
 
 #include "PrimaryGeneratorAction.hh"
 #include "PrimaryGeneratorMessenger.hh"
+#include "PhaseSpaceReader.hh"
+#include "OverlayEngine.hh"
+#include "SubEventInformation.hh"
+#include "EventSeeder.hh"
 
 #include "G4GeneralParticleSource.hh"
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
+#include "G4Poisson.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-PrimaryGeneratorAction::PrimaryGeneratorAction()
+PrimaryGeneratorAction::PrimaryGeneratorAction(OverlayEngine* overlay)
   : G4VUserPrimaryGeneratorAction(),
   fParticleGun(0),
+  fPhaseSpace(0),
+  fOverlay(overlay),
   fGunMessenger(0),
-  fBeamMultiplicity(1)
+  fBeamMultiplicity(1),
+  fPoissonMultiplicity(false),
+  fSubEvents(1),
+  fFirstEvent(0)
 {
   fParticleGun  = new G4GeneralParticleSource();
   
@@ -59,6 +69,7 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
 PrimaryGeneratorAction::~PrimaryGeneratorAction()
 {
   delete fParticleGun;
+  delete fPhaseSpace;
   delete fGunMessenger;
 }
 
@@ -66,9 +77,56 @@ PrimaryGeneratorAction::~PrimaryGeneratorAction()
 
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
-  //G4cout << "Beam particle number is: " << beamPartNb << G4endl;
-  for(int i=0; i<fBeamMultiplicity; i++){
-    fParticleGun->GeneratePrimaryVertex(anEvent);
+  // A job split over processes gets a slice of the event range, a replay
+  // the events of its list: set the event ID first, so that the bunches,
+  // the replayed phase space and the output all see the IDs of the whole
+  // job. The random numbers of the event then only depend on its ID
+  if(EventSeeder::IsReplaying()) anEvent->SetEventID(EventSeeder::ReplayedEventID(anEvent->GetEventID()));
+  else if(fFirstEvent > 0) anEvent->SetEventID(fFirstEvent + anEvent->GetEventID());
+  EventSeeder::SeedEvent(anEvent->GetEventID());
+
+  // With sub-events, the bunch is shared by fSubEvents consecutive events:
+  // each one gets its slice of the primaries (or of the Poisson mean)
+  G4int bunchID = anEvent->GetEventID();
+  G4int firstPrimary = 0;
+  G4int multiplicity = fBeamMultiplicity;
+  G4double meanMultiplicity = fBeamMultiplicity;
+  if(fSubEvents > 1){
+    bunchID = anEvent->GetEventID() / fSubEvents;
+    G4int subEvent = anEvent->GetEventID() % fSubEvents;
+    anEvent->SetUserInformation(new SubEventInformation(bunchID, subEvent, fSubEvents));
+    firstPrimary = G4int(G4long(fBeamMultiplicity)*subEvent/fSubEvents);
+    multiplicity = G4int(G4long(fBeamMultiplicity)*(subEvent+1)/fSubEvents) - firstPrimary;
+    meanMultiplicity /= fSubEvents;
+  }
+  if(fPoissonMultiplicity) multiplicity = G4int(G4Poisson(meanMultiplicity));
+  //G4cout << "Beam particle number is: " << multiplicity << G4endl;
+
+  // Overlay: nothing is transported, the bunch is made of library entries
+  if(fOverlay && fOverlay->IsOverlaying()){
+    fOverlay->Draw(multiplicity);
+    return;
+  }
+  if(fOverlay && fOverlay->IsBuilding() && multiplicity != 1){
+    G4Exception("PrimaryGeneratorAction::GeneratePrimaries()", "MyCode0016", JustWarning,
+      "Overlay library entries must be single-primary events: use multiplicity 1");
+  }
+
+  // Replaying a phase space, each beam particle is one recorded event,
+  // taken in sequence from the bunch ID. Each bunch (sub-event) owns
+  // fBeamMultiplicity (its share) recorded events: a Poisson multiplicity
+  // above it would reuse those of the next one
+  if(fPhaseSpace && fPoissonMultiplicity){
+    G4Exception("PrimaryGeneratorAction::GeneratePrimaries()", "MyCode0029", FatalException,
+      "Poisson multiplicity cannot be used with /btf/gun/replayPhaseSpace");
+  }
+  for(int i=0; i<multiplicity; i++){
+    if(fPhaseSpace){
+      fPhaseSpace->GenerateGroup(anEvent, std::size_t(bunchID)*fBeamMultiplicity + firstPrimary + i);
+    }
+    else{
+      fParticleGun->GeneratePrimaryVertex(anEvent);
+    }
   }
 }
 
@@ -78,4 +136,14 @@ void PrimaryGeneratorAction::SetBeamMultiplicity(G4int beamMultiplicity){
   fBeamMultiplicity = beamMultiplicity;
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetPhaseSpaceFile(const G4String& fileName){
+  delete fPhaseSpace;
+  fPhaseSpace = 0;
+  // An empty name goes back to the particle source
+  if(fileName.empty()) return;
+  fPhaseSpace = new PhaseSpaceReader(fileName);
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
\ No newline at end of file
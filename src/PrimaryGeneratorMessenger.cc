@@ -38,6 +38,8 @@
 
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithABool.hh"
 
 
 
@@ -45,7 +47,11 @@ PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(PrimaryGeneratorAction* Gun
  :G4UImessenger(),
   fAction(Gun),
   fGunDir(0),
-  fBeamMultiplicity(0)
+  fBeamMultiplicity(0),
+  fPoissonCmd(0),
+  fSubEventsCmd(0),
+  fFirstEventCmd(0),
+  fPhaseSpaceCmd(0)
 {
   fGunDir = new G4UIdirectory("/btf/gun/");
   fGunDir->SetGuidance("BTF beam control");
@@ -56,6 +62,40 @@ PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(PrimaryGeneratorAction* Gun
   fBeamMultiplicity->SetDefaultValue(1);
   fBeamMultiplicity->SetRange("multiplicity > 0");
   fBeamMultiplicity->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
+
+  fPoissonCmd = new G4UIcmdWithABool("/btf/gun/setPoisson",this);
+  fPoissonCmd->SetGuidance("draw the multiplicity of each bunch from a Poisson distribution");
+  fPoissonCmd->SetGuidance("whose mean is the multiplicity set with /btf/gun/setMultiplicity");
+  fPoissonCmd->SetParameterName("poisson", true);
+  fPoissonCmd->SetDefaultValue(true);
+  fPoissonCmd->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
+
+  fSubEventsCmd = new G4UIcmdWithAnInteger("/btf/gun/setSubEvents",this);
+  fSubEventsCmd->SetGuidance("split each bunch into n sub-events, processed in parallel by the worker threads");
+  fSubEventsCmd->SetGuidance("and merged back before filling the output: /run/beamOn must then be given");
+  fSubEventsCmd->SetGuidance("n times the number of bunches. Output event IDs are the bunch IDs.");
+  fSubEventsCmd->SetParameterName("nofSubEvents", false);
+  fSubEventsCmd->SetDefaultValue(1);
+  fSubEventsCmd->SetRange("nofSubEvents > 0");
+  fSubEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fFirstEventCmd = new G4UIcmdWithAnInteger("/btf/gun/firstEvent",this);
+  fFirstEventCmd->SetGuidance("event ID of the first event of the next runs, for a job split over processes");
+  fFirstEventCmd->SetGuidance("(see launch.sh): the events of /run/beamOn n get the IDs first ... first+n-1.");
+  fFirstEventCmd->SetGuidance("With sub-events, it must be a multiple of the number of sub-events.");
+  fFirstEventCmd->SetParameterName("firstEvent", false);
+  fFirstEventCmd->SetDefaultValue(0);
+  fFirstEventCmd->SetRange("firstEvent >= 0");
+  fFirstEventCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fPhaseSpaceCmd = new G4UIcmdWithAString("/btf/gun/replayPhaseSpace",this);
+  fPhaseSpaceCmd->SetGuidance("start the events from a phase-space file recorded in front of the DUT box");
+  fPhaseSpaceCmd->SetGuidance("(see /btf/det/recordPhaseSpace); each beam particle is one recorded event.");
+  fPhaseSpaceCmd->SetGuidance("Not with a Poisson multiplicity (/btf/gun/setPoisson).");
+  fPhaseSpaceCmd->SetGuidance("Without argument, go back to the particle source.");
+  fPhaseSpaceCmd->SetParameterName("fileName", true);
+  fPhaseSpaceCmd->SetDefaultValue("");
+  fPhaseSpaceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 
 
@@ -64,6 +104,10 @@ PrimaryGeneratorMessenger::~PrimaryGeneratorMessenger()
 {
   delete fGunDir;
   delete fBeamMultiplicity;
+  delete fPoissonCmd;
+  delete fSubEventsCmd;
+  delete fFirstEventCmd;
+  delete fPhaseSpaceCmd;
 }
 
 
@@ -71,6 +115,10 @@ PrimaryGeneratorMessenger::~PrimaryGeneratorMessenger()
 void PrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
 {
   if (command == fBeamMultiplicity) fAction->SetBeamMultiplicity(fBeamMultiplicity->GetNewIntValue(newValue));
+  if (command == fPoissonCmd) fAction->SetPoissonMultiplicity(fPoissonCmd->GetNewBoolValue(newValue));
+  if (command == fSubEventsCmd) fAction->SetSubEvents(fSubEventsCmd->GetNewIntValue(newValue));
+  if (command == fFirstEventCmd) fAction->SetFirstEvent(fFirstEventCmd->GetNewIntValue(newValue));
+  if (command == fPhaseSpaceCmd) fAction->SetPhaseSpaceFile(newValue);
 }
 
 
@@ -0,0 +1,77 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ProfilerMessenger.cc
+/// \brief Implementation of the ProfilerMessenger class
+
+#include "ProfilerMessenger.hh"
+#include "StepProfiler.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+
+
+ProfilerMessenger::ProfilerMessenger(StepProfiler* profiler)
+ :G4UImessenger(),
+  fProfiler(profiler),
+  fProfileDir(0),
+  fEnableCmd(0),
+  fRowsCmd(0)
+{
+  fProfileDir = new G4UIdirectory("/btf/profile/");
+  fProfileDir->SetGuidance("BTF step and time profiler");
+
+  fEnableCmd = new G4UIcmdWithABool("/btf/profile/enable",this);
+  fEnableCmd->SetGuidance("count the steps, tracks and wall time per logical volume, particle and process;");
+  fEnableCmd->SetGuidance("the report is printed at the end of each run");
+  fEnableCmd->SetParameterName("enable", true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fRowsCmd = new G4UIcmdWithAnInteger("/btf/profile/rows",this);
+  fRowsCmd->SetGuidance("number of rows of the report (the most expensive ones)");
+  fRowsCmd->SetParameterName("nofRows", false);
+  fRowsCmd->SetRange("nofRows > 0");
+  fRowsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+
+
+ProfilerMessenger::~ProfilerMessenger()
+{
+  delete fProfileDir;
+  delete fEnableCmd;
+  delete fRowsCmd;
+}
+
+
+
+void ProfilerMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fEnableCmd) fProfiler->SetEnabled(fEnableCmd->GetNewBoolValue(newValue));
+  if (command == fRowsCmd) StepProfiler::SetNofReportRows(fRowsCmd->GetNewIntValue(newValue));
+}
@@ -31,18 +31,62 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #include "RunAction.hh"
+#include "RunMessenger.hh"
+#include "AsyncWriter.hh"
 #include "Analysis.hh"
+#include "PhaseSpaceSD.hh"
+#include "BunchAssembler.hh"
+#include "StackingAction.hh"
+#include "StepProfiler.hh"
+#include "TrackingAction.hh"
+#include "StepTracer.hh"
+#include "SteppingAction.hh"
+#include "EventSeeder.hh"
 
 #include "G4Run.hh"
+#include "G4EventManager.hh"
 #include "G4RunManager.hh"
+#include "G4SDManager.hh"
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4AutoLock.hh"
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <sys/resource.h>
+
+namespace {
+  // Initialized when the program is loaded: reference for the
+  // initialization time reported at the start of the first run
+  const auto programStart = std::chrono::steady_clock::now();
+  G4bool initializationReported = false;
+
+  // Event loop of each worker in the run, printed by the master
+  struct WorkerThroughput {
+    G4int    fThreadID;
+    G4int    fNofEvents;
+    G4double fTime;
+    std::chrono::steady_clock::time_point fEnd;
+  };
+  G4Mutex throughputMutex = G4MUTEX_INITIALIZER;
+  std::vector<WorkerThroughput> workerThroughputs;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 RunAction::RunAction()
- : G4UserRunAction()
+ : G4UserRunAction(),
+   fRunMessenger(0),
+   fEventSchema(false),
+   fStackingAction(0),
+   fSteppingAction(0),
+   fStepProfiler(0),
+   fTrackingAction(0),
+   fStepTracer(0)
 {
+  fRunMessenger = new RunMessenger(this);
+
   // set printing event number per each event
   //G4RunManager::GetRunManager()->SetPrintProgress(1); 
 
@@ -60,6 +104,9 @@ RunAction::RunAction()
   analysisManager->SetVerboseLevel(1);
   analysisManager->SetNtupleMerging(true);
   // Note: merging ntuples is available only with Root output
+  // The layer-wise and event-wise ntuples are both booked and activated
+  // at the start of each run following /btf/output/eventSchema
+  analysisManager->SetActivation(true);
   
   // Book histograms, ntuple
   //
@@ -110,26 +157,88 @@ RunAction::RunAction()
   analysisManager->CreateNtupleDColumn(2, "etotSP");
   analysisManager->CreateNtupleSColumn(2, "wafer");
   analysisManager->FinishNtuple(2);
+  //
+  // Event-wise alternative to the three trees above: one row per event with
+  // a deposit in a wafer, the columns of each wafer suffixed with its name,
+  // the layers in vector columns (as many entries as layers, index =
+  // layer-1) and all the energies in keV
+  analysisManager->CreateNtuple("DUTEvents", "Sensors tree, one row per event");
+  analysisManager->CreateNtupleIColumn(3, "event");
+  for (G4int wafer = 0; wafer < kNofWafers; ++wafer) {
+    G4String suffix = (wafer == kWafer110um) ? "_110um" : "_150um";
+    analysisManager->CreateNtupleDColumn(3, "etot" + suffix);
+    analysisManager->CreateNtupleDColumn(3, "etotLP" + suffix);
+    analysisManager->CreateNtupleDColumn(3, "etotSP" + suffix);
+    analysisManager->CreateNtupleDColumn(3, "edep" + suffix, fLayerEdep[wafer]);
+    analysisManager->CreateNtupleDColumn(3, "edepPosX" + suffix, fLayerPosX[wafer]);
+    analysisManager->CreateNtupleDColumn(3, "edepPosY" + suffix, fLayerPosY[wafer]);
+    analysisManager->CreateNtupleDColumn(3, "edepPosZ" + suffix, fLayerPosZ[wafer]);
+  }
+  analysisManager->FinishNtuple(3);
+  //
+  // Pad readout: one row per event, wafer and pad with a deposit. The wafer
+  // is kWafer110um (0) or kWafer150um (1), the pad the index in
+  // PadLayout::kPads (large pads 1-4, then small pads 1-4), the edep in keV
+  // and the charge in thousands of electron-hole pairs (27 eV per pair)
+  analysisManager->CreateNtuple("PADS", "Pad readout tree");
+  analysisManager->CreateNtupleIColumn(4, "event");
+  analysisManager->CreateNtupleIColumn(4, "wafer");
+  analysisManager->CreateNtupleIColumn(4, "pad");
+  analysisManager->CreateNtupleDColumn(4, "edep");
+  analysisManager->CreateNtupleDColumn(4, "charge");
+  analysisManager->FinishNtuple(4);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 RunAction::~RunAction()
 {
+  delete fRunMessenger;
    //delete G4AnalysisManager::Instance();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void RunAction::BeginOfRunAction(const G4Run*)
+void RunAction::BeginOfRunAction(const G4Run* run)
 {
-  // show Rndm status
+  // Worker: without profiler or tracer, the steps skip the user stepping
+  // action (still owned by the run manager)
+  if (fSteppingAction) {
+    G4UserSteppingAction* steppingAction = 0;
+    if (fSteppingAction->IsNeeded()) steppingAction = fSteppingAction;
+    G4EventManager::GetEventManager()->SetUserAction(steppingAction);
+  }
+  if (fStackingAction) fStackingAction->BeginOfRun();
+
+  // show Rndm status, then fix the seed of the run for the events
   if (isMaster) G4Random::showEngineStatus();
-  
+  if (isMaster) EventSeeder::BeginOfRun(run->GetRunID());
+
+  // Timing (master): the geometry, physics and physics tables of the master
+  // are built when the first run starts. The workers time their event loop
+  fRunStart = std::chrono::steady_clock::now();
+  if (isMaster) {
+    if (! initializationReported) {
+      std::chrono::duration<G4double> initTime = fRunStart - programStart;
+      G4cout << "---> Initialization time: " << std::setprecision(4)
+             << initTime.count() << " s" << std::setprecision(6) << G4endl;
+      initializationReported = true;
+    }
+  }
+
+  // start the run without sub-events of a previous bunch
+  if (isMaster) BunchAssembler::Instance()->Reset();
+
+  // the writer thread must run before the workers start their events
+  if (isMaster && ! fAsyncFile.empty()) AsyncWriter::Instance()->Start(fAsyncFile);
 
    // Get analysis manager
   G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
 
+  // Select the ntuple schema
+  for (G4int id = 0; id < 3; ++id) analysisManager->SetNtupleActivation(id, ! fEventSchema);
+  analysisManager->SetNtupleActivation(3, fEventSchema);
+
   // Open an output file
   //
   G4String fileName = analysisManager->GetFileName();
@@ -141,10 +250,63 @@ void RunAction::BeginOfRunAction(const G4Run*)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void RunAction::EndOfRunAction(const G4Run*)
+void RunAction::EndOfRunAction(const G4Run* run)
 {  
   // show Rndm status
   if (isMaster) G4Random::showEngineStatus();         
+
+  // Throughput (master), including the worker initialization in MT mode
+  if (isMaster) {
+    std::chrono::duration<G4double> runTime = std::chrono::steady_clock::now() - fRunStart;
+    auto nofEvents = run->GetNumberOfEvent();
+    G4cout << "---> Run " << run->GetRunID() << ": " << nofEvents << " events in "
+           << std::setprecision(4) << runTime.count() << " s, "
+           << (runTime.count() > 0. ? nofEvents/runTime.count() : 0.) << " events/s"
+           << std::setprecision(6) << G4endl;
+    // ru_maxrss is in kB on Linux
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    G4cout << "---> Peak RSS: " << std::setprecision(4) << usage.ru_maxrss/1024. << " MB"
+           << std::setprecision(6) << G4endl;
+  }
+
+  // Per-thread throughput, to check the balance of the workers
+  if (! isMaster) {
+    auto loopEnd = std::chrono::steady_clock::now();
+    std::chrono::duration<G4double> loopTime = loopEnd - fRunStart;
+    G4AutoLock lock(&throughputMutex);
+    workerThroughputs.push_back({G4Threading::G4GetThreadId(), run->GetNumberOfEvent(),
+                                 loopTime.count(), loopEnd});
+  }
+  else {
+    G4AutoLock lock(&throughputMutex);
+    if (! workerThroughputs.empty()) {
+      std::sort(workerThroughputs.begin(), workerThroughputs.end(),
+                [](const WorkerThroughput& a, const WorkerThroughput& b) { return a.fThreadID < b.fThreadID; });
+      // idle: waiting for the last worker to finish its events
+      auto lastEnd = workerThroughputs.front().fEnd;
+      for (const auto& worker : workerThroughputs) lastEnd = std::max(lastEnd, worker.fEnd);
+      G4double totalTime = 0., totalIdle = 0.;
+      G4cout << "---> Per-thread throughput:" << G4endl
+             << std::setw(10) << "thread" << std::setw(12) << "events"
+             << std::setw(12) << "time [s]" << std::setw(12) << "events/s"
+             << std::setw(12) << "idle [s]" << G4endl;
+      for (const auto& worker : workerThroughputs) {
+        std::chrono::duration<G4double> idle = lastEnd - worker.fEnd;
+        totalTime += worker.fTime + idle.count();
+        totalIdle += idle.count();
+        G4cout << std::setw(10) << worker.fThreadID << std::setw(12) << worker.fNofEvents
+               << std::setw(12) << std::setprecision(4) << worker.fTime
+               << std::setw(12) << (worker.fTime > 0. ? worker.fNofEvents/worker.fTime : 0.)
+               << std::setw(12) << idle.count()
+               << std::setprecision(6) << G4endl;
+      }
+      G4cout << "---> Worker idle time: " << std::setprecision(4) << totalIdle << " s, "
+             << (totalTime > 0. ? 100.*totalIdle/totalTime : 0.) << " % of the worker time"
+             << std::setprecision(6) << G4endl;
+      workerThroughputs.clear();
+    }
+  }
   
   auto analysisManager = G4AnalysisManager::Instance();
   // print histogram statistics
@@ -164,10 +326,48 @@ void RunAction::EndOfRunAction(const G4Run*)
        << G4BestUnit(analysisManager->GetH1(0)->rms(),  "Energy") << G4endl;
     }
 
+  // the bunches split into sub-events must all be complete
+  if ( isMaster ) {
+    auto nofDropped = BunchAssembler::Instance()->DropIncomplete();
+    if ( nofDropped > 0 ) {
+      G4ExceptionDescription msg;
+      msg << nofDropped << " incomplete bunch(es) dropped: the number of events" << G4endl
+          << "should be a multiple of the number of sub-events (/btf/gun/setSubEvents)";
+      G4Exception("RunAction::EndOfRunAction()",
+        "MyCode0017", JustWarning, msg);
+    }
+  }
+
+  // tracks killed by the stacking rules: the workers (or the sequential run
+  // manager) add their counts, the master prints the totals
+  if ( fStackingAction ) fStackingAction->EndOfRun();
+  if ( isMaster ) StackingAction::PrintKills();
+
+  // same for the step profile, if enabled
+  if ( fStepProfiler ) fStepProfiler->EndOfRun();
+  if ( isMaster ) StepProfiler::PrintReport();
+
+  // and for the secondary census
+  if ( fTrackingAction ) fTrackingAction->EndOfRun();
+  if ( isMaster ) TrackingAction::PrintCensus();
+
+  // the workers are done: write out the rest of the event records
+  if (isMaster) AsyncWriter::Instance()->Stop();
+
   // save histograms & ntuple
   //
   analysisManager->Write();
   analysisManager->CloseFile();
+
+  // write out the buffered step records of this thread
+  if ( fStepTracer ) fStepTracer->EndOfRun();
+
+  // write out the buffered phase-space records of this thread
+  auto sdManager = G4SDManager::GetSDMpointerIfExist();
+  if ( sdManager ) {
+    auto phaseSpace = sdManager->FindSensitiveDetector("PhaseSpace", false);
+    if ( phaseSpace ) static_cast<PhaseSpaceSD*>(phaseSpace)->Flush();
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
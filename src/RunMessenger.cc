@@ -0,0 +1,86 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm4/src/RunMessenger.cc
+/// \brief Implementation of the RunMessenger class
+//
+//
+//
+// 
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RunMessenger.hh"
+#include "RunAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithABool.hh"
+
+
+
+RunMessenger::RunMessenger(RunAction* runAction)
+ :G4UImessenger(),
+  fRunAction(runAction),
+  fOutputDir(0),
+  fAsyncFileCmd(0),
+  fEventSchemaCmd(0)
+{
+  fOutputDir = new G4UIdirectory("/btf/output/");
+  fOutputDir->SetGuidance("BTF output control");
+
+  fAsyncFileCmd = new G4UIcmdWithAString("/btf/output/asyncFile",this);
+  fAsyncFileCmd->SetGuidance("write the event records to the given binary file from a dedicated thread");
+  fAsyncFileCmd->SetGuidance("instead of filling the ntuples (histograms are still filled).");
+  fAsyncFileCmd->SetGuidance("Without argument, go back to the ntuples.");
+  fAsyncFileCmd->SetParameterName("fileName", true);
+  fAsyncFileCmd->SetDefaultValue("");
+  fAsyncFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fEventSchemaCmd = new G4UIcmdWithABool("/btf/output/eventSchema",this);
+  fEventSchemaCmd->SetGuidance("fill the DUTEvents ntuple (one row per event, columns per wafer, layers");
+  fEventSchemaCmd->SetGuidance("in vector columns, energies in keV) instead of the DUTs, RUN and AUX ntuples");
+  fEventSchemaCmd->SetParameterName("eventSchema", true);
+  fEventSchemaCmd->SetDefaultValue(true);
+  fEventSchemaCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+
+
+RunMessenger::~RunMessenger()
+{
+  delete fOutputDir;
+  delete fAsyncFileCmd;
+  delete fEventSchemaCmd;
+}
+
+
+
+void RunMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fAsyncFileCmd) fRunAction->SetAsyncFile(newValue);
+  if (command == fEventSchemaCmd) fRunAction->SetEventSchema(fEventSchemaCmd->GetNewBoolValue(newValue));
+}
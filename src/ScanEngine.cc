@@ -0,0 +1,198 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ScanEngine.cc
+/// \brief Implementation of the ScanEngine class
+
+#include "ScanEngine.hh"
+#include "ScanMessenger.hh"
+
+#include "Analysis.hh"
+#include "G4UImanager.hh"
+#include "G4ios.hh"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScanEngine::ScanEngine()
+ : fMessenger(0),
+   fNofEvents(0)
+{
+  fMessenger = new ScanMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScanEngine::~ScanEngine()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ScanEngine::Read(const G4String& specFile)
+{
+  fNofEvents = 0;
+  fOutput = "scan";
+  fParameters.clear();
+  fPoints.clear();
+
+  std::ifstream file(specFile);
+  if ( ! file ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open the scan specification " << specFile;
+    G4Exception("ScanEngine::Read()", "MyCode0026", JustWarning, msg);
+    return false;
+  }
+
+  std::string line;
+  G4int lineNumber = 0;
+  while ( std::getline(file, line) ) {
+    lineNumber++;
+    auto comment = line.find('#');
+    if ( comment != std::string::npos ) line.erase(comment);
+    std::istringstream is(line);
+    std::string keyword;
+    if ( ! (is >> keyword) ) continue;
+
+    G4bool ok = true;
+    if ( keyword == "events" ) {
+      ok = static_cast<G4bool>(is >> fNofEvents) && fNofEvents > 0;
+    }
+    else if ( keyword == "output" ) {
+      std::string output;
+      ok = static_cast<G4bool>(is >> output);
+      fOutput = output;
+    }
+    else if ( keyword == "param" ) {
+      std::string name, command;
+      ok = static_cast<G4bool>(is >> name) && std::getline(is >> std::ws, command)
+           && command.find("{}") != std::string::npos && fPoints.empty();
+      fParameters.push_back({name, command});
+    }
+    else if ( keyword == "point" ) {
+      Point point;
+      std::string label, value;
+      ok = static_cast<G4bool>(is >> label);
+      point.fLabel = label;
+      while ( is >> value ) point.fValues.push_back(value);
+      ok = ok && point.fValues.size() == fParameters.size();
+      fPoints.push_back(point);
+    }
+    else {
+      ok = false;
+    }
+
+    if ( ! ok ) {
+      G4ExceptionDescription msg;
+      msg << specFile << ":" << lineNumber << ": invalid line" << G4endl << line;
+      G4Exception("ScanEngine::Read()", "MyCode0026", JustWarning, msg);
+      return false;
+    }
+  }
+
+  if ( fNofEvents <= 0 || fPoints.empty() ) {
+    G4ExceptionDescription msg;
+    msg << specFile << ": the number of events and at least one point are needed";
+    G4Exception("ScanEngine::Read()", "MyCode0026", JustWarning, msg);
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ScanEngine::Apply(const G4String& command) const
+{
+  auto status = G4UImanager::GetUIpointer()->ApplyCommand(command);
+  if ( status == 0 ) return true;
+
+  G4ExceptionDescription msg;
+  msg << "Command failed (status " << status << "): " << command << G4endl
+      << "the scan is stopped";
+  G4Exception("ScanEngine::Apply()", "MyCode0026", JustWarning, msg);
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScanEngine::Run(const G4String& specFile)
+{
+  if ( ! Read(specFile) ) return;
+
+  std::ofstream summary(fOutput + ".csv");
+  summary << "label";
+  for ( const auto& parameter : fParameters ) summary << "," << parameter.fName;
+  summary << ",events,time_s" << std::endl;
+
+  // file name in force, restored after the scan (the run action falls
+  // back to dutOut.root when none is set)
+  G4String fileName = G4AnalysisManager::Instance()->GetFileName();
+  if ( fileName.empty() ) fileName = "dutOut.root";
+
+  // values in force, empty until the parameter is first applied
+  std::vector<G4String> current(fParameters.size());
+  G4int nofPoints = 0;
+  for ( const auto& point : fPoints ) {
+    G4cout << G4endl << "---> Scan point " << nofPoints+1 << "/" << fPoints.size()
+           << ": " << point.fLabel;
+
+    G4bool ok = true;
+    for ( std::size_t i = 0; i < fParameters.size() && ok; ++i ) {
+      if ( point.fValues[i] == current[i] ) continue;
+      G4cout << " " << fParameters[i].fName << "=" << point.fValues[i];
+      auto command = fParameters[i].fCommand;
+      command.replace(command.find("{}"), 2, point.fValues[i]);
+      ok = Apply(command);
+      current[i] = point.fValues[i];
+    }
+    G4cout << G4endl;
+
+    // the file name command is also broadcast to the workers
+    ok = ok && Apply("/analysis/setFileName " + fOutput + "_" + point.fLabel);
+    auto start = std::chrono::steady_clock::now();
+    std::ostringstream beamOn;
+    beamOn << "/run/beamOn " << fNofEvents;
+    ok = ok && Apply(beamOn.str());
+    if ( ! ok ) break;
+    std::chrono::duration<G4double> time = std::chrono::steady_clock::now() - start;
+
+    summary << point.fLabel;
+    for ( const auto& value : point.fValues ) summary << "," << value;
+    summary << "," << fNofEvents << "," << time.count() << std::endl;
+    nofPoints++;
+  }
+  Apply("/analysis/setFileName " + fileName);
+
+  G4cout << G4endl << "---> Scan " << specFile << ": " << nofPoints << " of "
+         << fPoints.size() << " points done, summary in " << fOutput << ".csv" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
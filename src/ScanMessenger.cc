@@ -0,0 +1,68 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ScanMessenger.cc
+/// \brief Implementation of the ScanMessenger class
+
+#include "ScanMessenger.hh"
+#include "ScanEngine.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+
+
+
+ScanMessenger::ScanMessenger(ScanEngine* scanEngine)
+ :G4UImessenger(),
+  fScanEngine(scanEngine),
+  fScanDir(0),
+  fRunCmd(0)
+{
+  fScanDir = new G4UIdirectory("/btf/scan/");
+  fScanDir->SetGuidance("BTF parameter scan in one process");
+
+  fRunCmd = new G4UIcmdWithAString("/btf/scan/run",this);
+  fRunCmd->SetGuidance("run one point of the scan specification file after the other,");
+  fRunCmd->SetGuidance("applying only the parameters that change (see ScanEngine.hh or scan.spec);");
+  fRunCmd->SetGuidance("each point writes <output>_<label>.root and a line of <output>.csv");
+  fRunCmd->SetParameterName("specFile", false);
+  fRunCmd->AvailableForStates(G4State_Idle);
+  fRunCmd->SetToBeBroadcasted(false);
+}
+
+
+
+ScanMessenger::~ScanMessenger()
+{
+  delete fScanDir;
+  delete fRunCmd;
+}
+
+
+
+void ScanMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fRunCmd) fScanEngine->Run(newValue);
+}
@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SchedulerMessenger.cc
+/// \brief Implementation of the SchedulerMessenger class
+
+#include "SchedulerMessenger.hh"
+#include "ChunkScheduler.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+
+
+SchedulerMessenger::SchedulerMessenger(ChunkScheduler* scheduler)
+ :G4UImessenger(),
+  fScheduler(scheduler),
+  fRunDir(0),
+  fChunkTimeCmd(0),
+  fMaxChunkCmd(0)
+{
+  fRunDir = new G4UIdirectory("/btf/run/");
+  fRunDir->SetGuidance("BTF event scheduling (TestEm4 -b adaptive)");
+
+  fChunkTimeCmd = new G4UIcmdWithADoubleAndUnit("/btf/run/chunkTime",this);
+  fChunkTimeCmd->SetGuidance("target wall time of a chunk of events dealt to a worker;");
+  fChunkTimeCmd->SetGuidance("the chunks still shrink to one event at the end of the run");
+  fChunkTimeCmd->SetParameterName("time", false);
+  fChunkTimeCmd->SetUnitCategory("Time");
+  fChunkTimeCmd->SetRange("time > 0");
+  fChunkTimeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMaxChunkCmd = new G4UIcmdWithAnInteger("/btf/run/maxChunk",this);
+  fMaxChunkCmd->SetGuidance("largest number of events in a chunk");
+  fMaxChunkCmd->SetParameterName("nofEvents", false);
+  fMaxChunkCmd->SetRange("nofEvents > 0");
+  fMaxChunkCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+
+
+SchedulerMessenger::~SchedulerMessenger()
+{
+  delete fRunDir;
+  delete fChunkTimeCmd;
+  delete fMaxChunkCmd;
+}
+
+
+
+void SchedulerMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fChunkTimeCmd) fScheduler->SetChunkTime(fChunkTimeCmd->GetNewDoubleValue(newValue));
+  if (command == fMaxChunkCmd) fScheduler->SetMaxChunk(fMaxChunkCmd->GetNewIntValue(newValue));
+}
@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SeedMessenger.cc
+/// \brief Implementation of the SeedMessenger class
+
+#include "SeedMessenger.hh"
+#include "EventSeeder.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+#include <sstream>
+
+
+
+SeedMessenger::SeedMessenger(EventSeeder* eventSeeder)
+ :G4UImessenger(),
+  fEventSeeder(eventSeeder),
+  fRandomDir(0),
+  fRunSeedCmd(0),
+  fReplayCmd(0)
+{
+  fRandomDir = new G4UIdirectory("/btf/random/");
+  fRandomDir->SetGuidance("BTF per-event seeding");
+
+  fRunSeedCmd = new G4UIcmdWithAnInteger("/btf/random/runSeed",this);
+  fRunSeedCmd->SetGuidance("base seed of the next runs: the engine of each event is seeded from");
+  fRunSeedCmd->SetGuidance("(run seed, event ID), the run seed from (base seed, run ID).");
+  fRunSeedCmd->SetGuidance("With 0, the base seed is drawn from the engine of the master at the");
+  fRunSeedCmd->SetGuidance("first run (see /random/setSeeds); the run seeds are printed");
+  fRunSeedCmd->SetParameterName("runSeed", false);
+  fRunSeedCmd->SetDefaultValue(0);
+  fRunSeedCmd->SetRange("runSeed >= 0");
+  fRunSeedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRunSeedCmd->SetToBeBroadcasted(false);
+
+  fReplayCmd = new G4UIcommand("/btf/random/replayEvents",this);
+  fReplayCmd->SetGuidance("run again some events of a run, one after the other in one thread");
+  fReplayCmd->SetGuidance("(job started with -t 1 or -r serial), into <file>_replay:");
+  fReplayCmd->SetGuidance("the run seed (printed at the start of the run) and the event IDs");
+  auto seedPrm = new G4UIparameter("runSeed", 'i', false);
+  seedPrm->SetParameterRange("runSeed > 0");
+  fReplayCmd->SetParameter(seedPrm);
+  auto eventsPrm = new G4UIparameter("eventIDs", 's', false);
+  eventsPrm->SetGuidance("event IDs, separated by blanks");
+  fReplayCmd->SetParameter(eventsPrm);
+  fReplayCmd->AvailableForStates(G4State_Idle);
+  fReplayCmd->SetToBeBroadcasted(false);
+}
+
+
+
+SeedMessenger::~SeedMessenger()
+{
+  delete fRandomDir;
+  delete fRunSeedCmd;
+  delete fReplayCmd;
+}
+
+
+
+void SeedMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fRunSeedCmd) fEventSeeder->SetRunSeed(fRunSeedCmd->GetNewIntValue(newValue));
+  if (command == fReplayCmd) {
+    // the last parameter takes the rest of the line
+    std::istringstream is(newValue);
+    G4long runSeed;
+    is >> runSeed;
+    std::vector<G4int> eventIDs;
+    G4int eventID;
+    while (is >> eventID) eventIDs.push_back(eventID);
+    fEventSeeder->Replay(runSeed, eventIDs);
+  }
+}
@@ -0,0 +1,254 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StackingAction.cc
+/// \brief Implementation of the StackingAction class
+
+#include "StackingAction.hh"
+#include "StackingMessenger.hh"
+#include "RunTotals.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4Track.hh"
+#include "G4RunManager.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <iomanip>
+#include <sstream>
+
+namespace {
+  // Kills of all the threads, per rule index (same rules in all the threads)
+  struct Kills {
+    G4String fRule;
+    G4long   fNofTracks = 0;
+    G4double fEkin = 0.;
+  };
+  RunTotals<std::size_t, Kills> kills;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::StackingAction()
+ : G4UserStackingAction(),
+   fMessenger(0),
+   fResolved(false),
+   fTarget(0, 0, 0),
+   fTargetSet(false)
+{
+  fMessenger = new StackingMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::~StackingAction()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::BeginOfRun()
+{
+  if ( fTargetSet ) return;
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  if ( detector ) fTarget = detector->GetDUTPosition();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* track)
+{
+  // The primaries are always tracked
+  if ( fRules.empty() || track->GetParentID() == 0 ) return fUrgent;
+  if ( ! fResolved ) ResolveRules();
+
+  for ( auto& rule : fRules ) {
+    if ( Kills(rule, track) ) {
+      rule.fNofKilled++;
+      rule.fEkinKilled += track->GetKineticEnergy();
+      return fKill;
+    }
+  }
+  return fUrgent;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool StackingAction::Kills(Rule& rule, const G4Track* track) const
+{
+  switch ( rule.fType ) {
+    case kMinEkin: {
+      if ( track->GetKineticEnergy() >= rule.fValue ) return false;
+      if ( rule.fParticleDef && rule.fParticleDef != track->GetDefinition() ) return false;
+      if ( rule.fRegion == "all" ) return true;
+      // the secondaries get the touchable of the step that created them
+      auto volume = track->GetVolume();
+      return volume && volume->GetLogicalVolume()->GetRegion() == rule.fRegionPtr;
+    }
+    case kAcceptance: {
+      if ( track->GetDefinition()->GetPDGCharge() != 0. ) return false;
+      auto toTarget = fTarget - track->GetPosition();
+      G4double distance = toTarget.mag();
+      if ( distance <= 0. ) return false;
+      return track->GetMomentumDirection().dot(toTarget) < rule.fValue*distance;
+    }
+    case kMaxTime:
+      return track->GetGlobalTime() > rule.fValue;
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::ResolveRules()
+{
+  // The particles and regions exist only once the run is initialized
+  auto particleTable = G4ParticleTable::GetParticleTable();
+  for ( auto& rule : fRules ) {
+    if ( rule.fType != kMinEkin ) continue;
+    if ( rule.fParticle != "all" ) {
+      rule.fParticleDef = particleTable->FindParticle(rule.fParticle);
+      if ( ! rule.fParticleDef ) {
+        G4ExceptionDescription msg;
+        msg << "Unknown particle " << rule.fParticle << " in stacking rule: " << rule.Describe();
+        G4Exception("StackingAction::ResolveRules()",
+          "MyCode0022", FatalException, msg);
+      }
+    }
+    if ( rule.fRegion != "all" ) {
+      rule.fRegionPtr = G4RegionStore::GetInstance()->GetRegion(rule.fRegion, false);
+      if ( ! rule.fRegionPtr ) {
+        G4ExceptionDescription msg;
+        msg << "Unknown region " << rule.fRegion << " in stacking rule: " << rule.Describe();
+        G4Exception("StackingAction::ResolveRules()",
+          "MyCode0023", FatalException, msg);
+      }
+    }
+  }
+  fResolved = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::AddMinEkinRule(const G4String& particle, const G4String& region, G4double minEkin)
+{
+  Rule rule;
+  rule.fType = kMinEkin;
+  rule.fParticle = particle;
+  rule.fRegion = region;
+  rule.fValue = minEkin;
+  fRules.push_back(rule);
+  fResolved = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::AddAcceptanceRule(G4double halfAngle)
+{
+  Rule rule;
+  rule.fType = kAcceptance;
+  rule.fValue = std::cos(halfAngle);
+  fRules.push_back(rule);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::AddMaxTimeRule(G4double maxTime)
+{
+  Rule rule;
+  rule.fType = kMaxTime;
+  rule.fValue = maxTime;
+  fRules.push_back(rule);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::ClearRules()
+{
+  fRules.clear();
+  fResolved = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String StackingAction::Rule::Describe() const
+{
+  std::ostringstream out;
+  switch ( fType ) {
+    case kMinEkin:
+      out << "minEkin " << fParticle << " " << fRegion << " " << G4BestUnit(fValue, "Energy");
+      break;
+    case kAcceptance:
+      out << "acceptance " << std::acos(fValue)/deg << " deg";
+      break;
+    case kMaxTime:
+      out << "maxTime " << G4BestUnit(fValue, "Time");
+      break;
+  }
+  return out.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::EndOfRun()
+{
+  kills.Update([this](RunTotals<std::size_t, Kills>::Map& map) {
+    for ( std::size_t i = 0; i < fRules.size(); ++i ) {
+      auto& total = map[i];
+      total.fRule = fRules[i].Describe();
+      total.fNofTracks += fRules[i].fNofKilled;
+      total.fEkin += fRules[i].fEkinKilled;
+      fRules[i].fNofKilled = 0;
+      fRules[i].fEkinKilled = 0.;
+    }
+  });
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::PrintKills()
+{
+  // In the order of the rules
+  auto totals = kills.Take();
+  if ( totals.empty() ) return;
+
+  G4cout << G4endl << " ----> tracks killed by the stacking rules" << G4endl;
+  for ( const auto& total : totals ) {
+    G4cout << "  " << std::setw(40) << std::left << total.second.fRule << std::right
+           << std::setw(12) << total.second.fNofTracks << " tracks, "
+           << G4BestUnit(total.second.fEkin, "Energy") << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
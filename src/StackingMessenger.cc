@@ -0,0 +1,126 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StackingMessenger.cc
+/// \brief Implementation of the StackingMessenger class
+
+#include "StackingMessenger.hh"
+#include "StackingAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+
+
+StackingMessenger::StackingMessenger(StackingAction* action)
+ :G4UImessenger(),
+  fAction(action),
+  fStackDir(0),
+  fMinEkinCmd(0),
+  fAcceptanceCmd(0),
+  fTargetCmd(0),
+  fMaxTimeCmd(0),
+  fClearCmd(0)
+{
+  fStackDir = new G4UIdirectory("/btf/stack/");
+  fStackDir->SetGuidance("BTF track-killing rules, tried in order on each new secondary");
+
+  fMinEkinCmd = new G4UIcommand("/btf/stack/minEkin",this);
+  fMinEkinCmd->SetGuidance("kill the secondaries of a particle (or all) created in a region (or all)");
+  fMinEkinCmd->SetGuidance("with a kinetic energy below the threshold");
+  fMinEkinCmd->SetGuidance("(regions: Sensor, Passive, DefaultRegionForTheWorld, AirGap)");
+  auto particlePrm = new G4UIparameter("particle", 's', false);
+  fMinEkinCmd->SetParameter(particlePrm);
+  auto regionPrm = new G4UIparameter("region", 's', false);
+  fMinEkinCmd->SetParameter(regionPrm);
+  auto valuePrm = new G4UIparameter("minEkin", 'd', false);
+  valuePrm->SetParameterRange("minEkin>0.");
+  fMinEkinCmd->SetParameter(valuePrm);
+  auto unitPrm = new G4UIparameter("unit", 's', true);
+  unitPrm->SetDefaultUnit("keV");
+  fMinEkinCmd->SetParameter(unitPrm);
+  fMinEkinCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fAcceptanceCmd = new G4UIcmdWithADoubleAndUnit("/btf/stack/acceptance",this);
+  fAcceptanceCmd->SetGuidance("kill the neutral secondaries not heading within a cone of this half angle");
+  fAcceptanceCmd->SetGuidance("around the direction to the target (/btf/stack/target)");
+  fAcceptanceCmd->SetParameterName("halfAngle", false);
+  fAcceptanceCmd->SetRange("halfAngle>0.");
+  fAcceptanceCmd->SetUnitCategory("Angle");
+  fAcceptanceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTargetCmd = new G4UIcmdWith3VectorAndUnit("/btf/stack/target",this);
+  fTargetCmd->SetGuidance("target point of the acceptance cone (default: the DUT box, following");
+  fTargetCmd->SetGuidance("/btf/det/dutPosition); a target set here stays fixed");
+  fTargetCmd->SetParameterName("x", "y", "z", false);
+  fTargetCmd->SetUnitCategory("Length");
+  fTargetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMaxTimeCmd = new G4UIcmdWithADoubleAndUnit("/btf/stack/maxTime",this);
+  fMaxTimeCmd->SetGuidance("kill the secondaries created after this global time");
+  fMaxTimeCmd->SetParameterName("maxTime", false);
+  fMaxTimeCmd->SetRange("maxTime>0.");
+  fMaxTimeCmd->SetUnitCategory("Time");
+  fMaxTimeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fClearCmd = new G4UIcmdWithoutParameter("/btf/stack/clear",this);
+  fClearCmd->SetGuidance("remove all the rules");
+  fClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+
+
+StackingMessenger::~StackingMessenger()
+{
+  delete fStackDir;
+  delete fMinEkinCmd;
+  delete fAcceptanceCmd;
+  delete fTargetCmd;
+  delete fMaxTimeCmd;
+  delete fClearCmd;
+}
+
+
+
+void StackingMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fMinEkinCmd) {
+    G4String particle, region, unit;
+    G4double value;
+    std::istringstream is(newValue);
+    is >> particle >> region >> value >> unit;
+    fAction->AddMinEkinRule(particle, region, value*G4UIcommand::ValueOf(unit));
+  }
+  if (command == fAcceptanceCmd) fAction->AddAcceptanceRule(fAcceptanceCmd->GetNewDoubleValue(newValue));
+  if (command == fTargetCmd) fAction->SetAcceptanceTarget(fTargetCmd->GetNew3VectorValue(newValue));
+  if (command == fMaxTimeCmd) fAction->AddMaxTimeRule(fMaxTimeCmd->GetNewDoubleValue(newValue));
+  if (command == fClearCmd) fAction->ClearRules();
+}
@@ -0,0 +1,191 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StepProfiler.cc
+/// \brief Implementation of the StepProfiler class
+
+#include "StepProfiler.hh"
+#include "ProfilerMessenger.hh"
+#include "RunTotals.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VProcess.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ios.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4EventManager.hh"
+
+#include <iomanip>
+#include <tuple>
+
+namespace {
+  // Totals of all the threads, by volume, particle and process names
+  using Key = std::tuple<G4String, G4String, G4String>;
+  struct Total {
+    G4long   fNofSteps = 0;
+    G4long   fNofTracks = 0;
+    G4double fTime = 0.;
+  };
+  RunTotals<Key, Total> totals;
+  // kept with the totals, under their lock
+  G4double totalEventOverhead = 0.;
+  G4int nofReportRows = 40;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepProfiler::StepProfiler()
+ : fMessenger(0),
+   fEnabled(false),
+   fLastEvent(nullptr),
+   fEventOverhead(0.)
+{
+  fMessenger = new ProfilerMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepProfiler::~StepProfiler()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfiler::SetNofReportRows(G4int nofRows)
+{
+  totals.Update([nofRows](RunTotals<Key, Total>::Map&) { nofReportRows = nofRows; });
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfiler::Step(const G4Step* step)
+{
+  auto now = std::chrono::steady_clock::now();
+  G4double time = std::chrono::duration<G4double>(now - fLastTime).count();
+  fLastTime = now;
+
+  // First step of an event: the time since the last step is the overhead
+  // of the event loop (end of the previous event, primary generation)
+  auto event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  if ( event != fLastEvent ) {
+    if ( fLastEvent ) fEventOverhead += time;
+    fLastEvent = event;
+    time = 0.;
+  }
+
+  auto track = step->GetTrack();
+  auto volume = step->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume();
+  G4int volumeID = volume->GetInstanceID();
+  G4int channelID = fChannels.ID(track->GetDefinition(),
+                                 step->GetPostStepPoint()->GetProcessDefinedStep());
+
+  if ( volumeID >= G4int(fCells.size()) ) {
+    fCells.resize(volumeID + 1);
+    fVolumes.resize(volumeID + 1, nullptr);
+  }
+  fVolumes[volumeID] = volume;
+  auto& cells = fCells[volumeID];
+  if ( channelID >= G4int(cells.size()) ) cells.resize(fChannels.Size());
+
+  auto& cell = cells[channelID];
+  cell.fNofSteps++;
+  if ( track->GetCurrentStepNumber() == 1 ) cell.fNofTracks++;
+  cell.fTime += time;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfiler::EndOfRun()
+{
+  totals.Update([this](RunTotals<Key, Total>::Map& map) {
+    for ( std::size_t volumeID = 0; volumeID < fCells.size(); ++volumeID ) {
+      for ( std::size_t channelID = 0; channelID < fCells[volumeID].size(); ++channelID ) {
+        auto& cell = fCells[volumeID][channelID];
+        if ( cell.fNofSteps == 0 ) continue;
+        auto process = fChannels[channelID].fProcess;
+        Key key(fVolumes[volumeID]->GetName(), fChannels[channelID].fParticle->GetParticleName(),
+                process ? process->GetProcessName() : G4String("none"));
+        auto& total = map[key];
+        total.fNofSteps += cell.fNofSteps;
+        total.fNofTracks += cell.fNofTracks;
+        total.fTime += cell.fTime;
+        cell = Cell();
+      }
+    }
+    totalEventOverhead += fEventOverhead;
+  });
+  fEventOverhead = 0.;
+  fLastEvent = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfiler::PrintReport()
+{
+  G4double eventOverhead = 0.;
+  G4int maxRows = 0;
+  totals.Update([&](RunTotals<Key, Total>::Map&) {
+    eventOverhead = totalEventOverhead;
+    totalEventOverhead = 0.;
+    maxRows = nofReportRows;
+  });
+  auto taken = totals.Take();
+  if ( taken.empty() ) return;
+
+  auto rows = RunTotals<Key, Total>::SortedRows(taken, [](const Total& total) { return total.fTime; });
+  G4long nofSteps = 0;
+  G4long nofTracks = 0;
+  G4double time = eventOverhead;
+  for ( const auto& row : rows ) {
+    nofSteps += row.second.fNofSteps;
+    nofTracks += row.second.fNofTracks;
+    time += row.second.fTime;
+  }
+
+  G4cout << G4endl << " ----> step profile (all threads, sorted by time)" << G4endl
+         << std::setw(36) << "volume" << std::setw(14) << "particle" << std::setw(22) << "process"
+         << std::setw(14) << "steps" << std::setw(12) << "tracks"
+         << std::setw(12) << "time [s]" << std::setw(8) << "%" << G4endl;
+  G4int nofRows = 0;
+  for ( const auto& row : rows ) {
+    if ( nofRows++ == maxRows ) break;
+    G4cout << std::setw(36) << std::get<0>(row.first) << std::setw(14) << std::get<1>(row.first)
+           << std::setw(22) << std::get<2>(row.first)
+           << std::setw(14) << row.second.fNofSteps << std::setw(12) << row.second.fNofTracks
+           << std::setw(12) << std::setprecision(4) << row.second.fTime
+           << std::setw(8) << std::setprecision(3) << (time > 0. ? 100.*row.second.fTime/time : 0.)
+           << G4endl;
+  }
+  G4cout << std::setw(72) << "event overhead" << std::setw(26) << ""
+         << std::setw(12) << std::setprecision(4) << eventOverhead << G4endl
+         << std::setw(72) << "total" << std::setw(14) << nofSteps << std::setw(12) << nofTracks
+         << std::setw(12) << time << std::setprecision(6) << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,173 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StepTracer.cc
+/// \brief Implementation of the StepTracer class
+
+#include "StepTracer.hh"
+#include "TraceMessenger.hh"
+#include "BinaryIO.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VProcess.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4EventManager.hh"
+#include "G4Event.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+
+namespace {
+  const std::size_t kBufferSize = 65536;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepTracer::StepTracer()
+ : fMessenger(0),
+   fLastProcess(nullptr),
+   fLastProcessID(-1)
+{
+  fMessenger = new TraceMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepTracer::~StepTracer()
+{
+  Close();
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepTracer::SetFileName(const G4String& fileName)
+{
+  Close();
+  fFileName = fileName;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int StepTracer::ProcessID(const G4VProcess* process)
+{
+  if ( ! process ) return -1;
+  if ( process == fLastProcess ) return fLastProcessID;
+  auto it = std::find(fProcesses.begin(), fProcesses.end(), process);
+  fLastProcessID = G4int(it - fProcesses.begin());
+  if ( it == fProcesses.end() ) fProcesses.push_back(process);
+  fLastProcess = process;
+  return fLastProcessID;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepTracer::Record(const G4Step* step)
+{
+  // The file of the thread is opened with the first step
+  if ( ! fFile.is_open() ) {
+    fThreadFileName = ThreadFileName(fFileName);
+    fFile.open(fThreadFileName, std::ios::binary | std::ios::trunc);
+    if ( ! fFile ) {
+      G4ExceptionDescription msg;
+      msg << "Cannot open step-trace file " << fThreadFileName; 
+      G4Exception("StepTracer::Record()",
+        "MyCode0024", FatalException, msg);
+    }
+    WriteBinaryHeader(fFile, kStepTraceMagic, kStepTraceVersion, sizeof(StepTraceRecord));
+    fBuffer.reserve(kBufferSize);
+  }
+
+  auto track = step->GetTrack();
+  auto postStepPoint = step->GetPostStepPoint();
+  auto volume = step->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume();
+  const auto& pos = postStepPoint->GetPosition();
+
+  StepTraceRecord record;
+  record.event = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+  record.track = track->GetTrackID();
+  record.parent = track->GetParentID();
+  record.pdg = track->GetDefinition()->GetPDGEncoding();
+  record.step = track->GetCurrentStepNumber();
+  record.volume = std::int16_t(volume->GetInstanceID());
+  record.process = std::int16_t(ProcessID(postStepPoint->GetProcessDefinedStep()));
+  record.x = pos.x();
+  record.y = pos.y();
+  record.z = pos.z();
+  record.ekin = postStepPoint->GetKineticEnergy();
+  record.edep = step->GetTotalEnergyDeposit();
+  if ( record.volume >= G4int(fVolumes.size()) ) fVolumes.resize(record.volume + 1, nullptr);
+  fVolumes[record.volume] = volume;
+
+  fBuffer.push_back(record);
+  if ( fBuffer.size() >= kBufferSize ) Flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepTracer::Flush()
+{
+  if ( fBuffer.empty() ) return;
+  fFile.write(reinterpret_cast<const char*>(fBuffer.data()),
+              fBuffer.size()*sizeof(StepTraceRecord));
+  fBuffer.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepTracer::EndOfRun()
+{
+  if ( ! fFile.is_open() ) return;
+  Flush();
+  fFile.flush();
+
+  // Names of the IDs used in this shard so far
+  std::ofstream names(fThreadFileName + ".names");
+  for ( std::size_t i = 0; i < fVolumes.size(); ++i ) {
+    if ( fVolumes[i] ) names << "volume " << i << " " << fVolumes[i]->GetName() << "\n";
+  }
+  for ( std::size_t i = 0; i < fProcesses.size(); ++i ) {
+    names << "process " << i << " " << fProcesses[i]->GetProcessName() << "\n";
+  }
+  G4cout << "---> Step trace written to " << fThreadFileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepTracer::Close()
+{
+  if ( ! fFile.is_open() ) return;
+  EndOfRun();
+  fFile.close();
+  fVolumes.clear();
+  fProcesses.clear();
+  fLastProcess = nullptr;
+  fLastProcessID = -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
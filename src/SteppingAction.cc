@@ -53,8 +53,9 @@ SteppingAction::~SteppingAction()
 
 void SteppingAction::UserSteppingAction(const G4Step* aStep)
 {
- G4double EdepStep = aStep->GetTotalEnergyDeposit();
- if (EdepStep > 0.) fEventAction->AddEdep(EdepStep);
+ // Only given to the kernel when one of them is enabled (see RunAction)
+ if (fProfiler.IsEnabled()) fProfiler.Step(aStep);
+ if (fTracer.IsEnabled()) fTracer.Record(aStep);
   
  //example of saving random number seed of this event, under condition
  //// if (condition) G4RunManager::GetRunManager()->rndmSaveThisEvent();  
@@ -0,0 +1,67 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file TraceMessenger.cc
+/// \brief Implementation of the TraceMessenger class
+
+#include "TraceMessenger.hh"
+#include "StepTracer.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+
+
+
+TraceMessenger::TraceMessenger(StepTracer* tracer)
+ :G4UImessenger(),
+  fTracer(tracer),
+  fTraceDir(0),
+  fFileCmd(0)
+{
+  fTraceDir = new G4UIdirectory("/btf/trace/");
+  fTraceDir->SetGuidance("BTF binary step trace");
+
+  fFileCmd = new G4UIcmdWithAString("/btf/trace/file",this);
+  fFileCmd->SetGuidance("write every step to this binary file (one file per worker thread),");
+  fFileCmd->SetGuidance("to be read with the readtrace tool. Without argument, stop tracing.");
+  fFileCmd->SetParameterName("fileName", true);
+  fFileCmd->SetDefaultValue("");
+  fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+
+
+TraceMessenger::~TraceMessenger()
+{
+  delete fTraceDir;
+  delete fFileCmd;
+}
+
+
+
+void TraceMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fFileCmd) fTracer->SetFileName(newValue);
+}
@@ -27,51 +27,109 @@
 // -------------------------------------------------------------------
 
 #include "TrackingAction.hh"
+#include "RunTotals.hh"
 #include "G4Track.hh"
-#include "G4VSolid.hh"
-#include "G4Region.hh"
-#include "DetectorConstruction.hh"
+#include "G4VProcess.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
 
+#include <iomanip>
+#include <map>
+#include <tuple>
 
-TrackingAction::TrackingAction(DetectorConstruction* detector){
-    fDetector = detector;
-    fTargetRegion = 0;
-}
+namespace {
+    // Secondaries of all the threads, by particle, volume and process names
+    using Key = std::tuple<G4String, G4String, G4String>;
+    RunTotals<Key, G4long> census;
+    const G4int nofJointRows = 20;
+
+    G4long Count(G4long count){ return count; }
 
-TrackingAction::~TrackingAction(){
-    fDetector = 0;
-    fTargetRegion = 0;
+    void PrintCounts(const G4String& title, const std::map<G4String, G4long>& counts, G4long total){
+        G4cout << "  per " << title << G4endl;
+        for(const auto& row : RunTotals<G4String, G4long>::SortedRows(counts, Count)){
+            G4cout << std::setw(40) << row.first << std::setw(14) << row.second
+                   << std::setw(8) << std::setprecision(3) << 100.*row.second/total << " %"
+                   << std::setprecision(6) << G4endl;
+        }
+    }
 }
 
+TrackingAction::TrackingAction()
+ : G4UserTrackingAction()
+{}
+
+TrackingAction::~TrackingAction()
+{}
+
 void TrackingAction::PreUserTrackingAction(const G4Track* track)
 {
-    const G4ParticleDefinition* particleDefinition = track->GetParticleDefinition();
+    // Primaries are not counted
+    auto process = track->GetCreatorProcess();
+    if(!process) return;
 
-    if(fTargetRegion == 0){
-        fTargetRegion = fDetector->GetTargetRegion();
-    }
+    auto volume = track->GetTouchable()->GetVolume()->GetLogicalVolume();
+    G4int volumeID = volume->GetInstanceID();
+    G4int channelID = fChannels.ID(track->GetParticleDefinition(), process);
 
-    const G4ThreeVector& position = track->GetPosition();
+    if(volumeID >= G4int(fCounts.size())){
+        fCounts.resize(volumeID + 1);
+        fVolumes.resize(volumeID + 1, nullptr);
+    }
+    auto& counts = fCounts[volumeID];
+    if(channelID >= G4int(counts.size())){
+        counts.resize(fChannels.Size(), 0);
+        fVolumes[volumeID] = volume;
+    }
+    counts[channelID]++;
+}
 
-    int N =  fTargetRegion->GetNumberOfRootVolumes();
-    std::vector<G4LogicalVolume*>::iterator it_logicalVolumeInRegion = fTargetRegion->GetRootLogicalVolumeIterator();
+void TrackingAction::EndOfRun()
+{
+    census.Update([this](RunTotals<Key, G4long>::Map& map){
+        for(std::size_t volumeID = 0; volumeID < fCounts.size(); ++volumeID){
+            for(std::size_t channelID = 0; channelID < fCounts[volumeID].size(); ++channelID){
+                auto& count = fCounts[volumeID][channelID];
+                if(count == 0) continue;
+                Key key(fChannels[channelID].fParticle->GetParticleName(), fVolumes[volumeID]->GetName(),
+                        fChannels[channelID].fProcess->GetProcessName());
+                map[key] += count;
+                count = 0;
+            }
+        }
+    });
+}
 
-    bool inside_volume = false;
+void TrackingAction::PrintCensus()
+{
+    auto joint = census.Take();
+    if(joint.empty()) return;
 
-    for(int i = 0; i < N ; i++, it_logicalVolumeInRegion++)
-    {
-        EInside test_status = (*it_logicalVolumeInRegion)->GetSolid()->Inside(position) ;
-        if (test_status == kInside){
-            inside_volume = true;
-            break;
-        }
+    std::map<G4String, G4long> particleCounts;
+    std::map<G4String, G4long> volumeCounts;
+    std::map<G4String, G4long> processCounts;
+    G4long total = 0;
+    for(const auto& count : joint){
+        particleCounts[std::get<0>(count.first)] += count.second;
+        volumeCounts[std::get<1>(count.first)] += count.second;
+        processCounts[std::get<2>(count.first)] += count.second;
+        total += count.second;
     }
 
-    if(inside_volume == true){
-        fNParticleInTarget[particleDefinition]++;
+    G4cout << G4endl << " ----> secondary census (all threads): " << total << " secondaries" << G4endl;
+    PrintCounts("particle", particleCounts, total);
+    PrintCounts("creation volume", volumeCounts, total);
+    PrintCounts("creator process", processCounts, total);
 
-        // Get kinetic energy of the alpha
-        G4cout << "---->------>------->------>Kinetic of init particle: " << track->GetKineticEnergy() << G4endl;
+    G4cout << "  per particle, creation volume and creator process (first " << nofJointRows
+           << " of " << joint.size() << ")" << G4endl;
+    G4int nofRows = 0;
+    for(const auto& row : RunTotals<Key, G4long>::SortedRows(joint, Count)){
+        if(nofRows++ == nofJointRows) break;
+        G4cout << std::setw(14) << std::get<0>(row.first) << std::setw(26) << std::get<1>(row.first)
+               << std::setw(22) << std::get<2>(row.first) << std::setw(14) << row.second
+               << std::setw(8) << std::setprecision(3) << 100.*row.second/total << " %"
+               << std::setprecision(6) << G4endl;
     }
 }
-
@@ -0,0 +1,181 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file WorkerInitialization.cc
+/// \brief Implementation of the WorkerInitialization class
+
+#include "WorkerInitialization.hh"
+
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+  // the workers report their placement one at a time
+  G4Mutex placementMutex = G4MUTEX_INITIALIZER;
+
+  // CPU list of the kernel, e.g. "0-7,16-23"
+  std::vector<G4int> ParseCpuList(const std::string& list)
+  {
+    std::vector<G4int> cpus;
+    std::istringstream stream(list);
+    std::string range;
+    while ( std::getline(stream, range, ',') ) {
+      if ( range.empty() ) continue;
+      auto dash = range.find('-');
+      auto first = std::stoi(range.substr(0, dash));
+      auto last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash+1));
+      for ( auto cpu = first; cpu <= last; ++cpu ) cpus.push_back(cpu);
+    }
+    return cpus;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+WorkerInitialization::WorkerInitialization(Pinning pinning)
+ : G4UserWorkerInitialization(),
+   fPinning(pinning)
+{
+  if ( fPinning == kNoPinning ) return;
+  fCpus = AvailableCpus();
+  if ( fPinning == kNumaPinning ) fNodes = NumaNodes(fCpus);
+  if ( fCpus.empty() ) {
+    G4Exception("WorkerInitialization::WorkerInitialization()", "MyCode0025", JustWarning,
+      "The affinity of the threads cannot be set on this system: the workers are not pinned");
+    fPinning = kNoPinning;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+WorkerInitialization::~WorkerInitialization()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool WorkerInitialization::ParsePinning(const G4String& name, Pinning& pinning)
+{
+  if      ( name == "none" ) pinning = kNoPinning;
+  else if ( name == "core" ) pinning = kCorePinning;
+  else if ( name == "numa" ) pinning = kNumaPinning;
+  else return false;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4int> WorkerInitialization::AvailableCpus()
+{
+  std::vector<G4int> cpus;
+#ifdef __linux__
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if ( sched_getaffinity(0, sizeof(mask), &mask) == 0 ) {
+    for ( G4int cpu = 0; cpu < CPU_SETSIZE; ++cpu ) {
+      if ( CPU_ISSET(cpu, &mask) ) cpus.push_back(cpu);
+    }
+  }
+#endif
+  return cpus;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int WorkerInitialization::AvailableCores()
+{
+  auto nofCpus = G4int(AvailableCpus().size());
+  return nofCpus > 0 ? nofCpus : G4Threading::G4GetNumberOfCores();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<std::vector<G4int>>
+WorkerInitialization::NumaNodes(const std::vector<G4int>& cpus)
+{
+  // The available CPUs of each node, from the sysfs topology; a single node
+  // if it cannot be read
+  std::vector<std::vector<G4int>> nodes;
+  for ( G4int node = 0; ; ++node ) {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if ( ! file ) break;
+    std::string list;
+    std::getline(file, list);
+    std::vector<G4int> nodeCpus;
+    for ( auto cpu : ParseCpuList(list) ) {
+      for ( auto available : cpus ) {
+        if ( cpu == available ) nodeCpus.push_back(cpu);
+      }
+    }
+    if ( ! nodeCpus.empty() ) nodes.push_back(nodeCpus);
+  }
+  if ( nodes.empty() ) nodes.push_back(cpus);
+  return nodes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void WorkerInitialization::WorkerStart() const
+{
+  if ( fPinning == kNoPinning ) return;
+  auto threadID = G4Threading::G4GetThreadId();
+  if ( threadID < 0 ) return;
+
+  const auto& cpus = ( fPinning == kCorePinning )
+    ? std::vector<G4int>{ fCpus[threadID % fCpus.size()] }
+    : fNodes[threadID % fNodes.size()];
+
+#ifdef __linux__
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for ( auto cpu : cpus ) CPU_SET(cpu, &mask);
+  auto status = pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+
+  G4AutoLock lock(&placementMutex);
+  if ( status != 0 ) {
+    G4ExceptionDescription msg;
+    msg << "Worker " << threadID << " could not be pinned (error " << status << ")";
+    G4Exception("WorkerInitialization::WorkerStart()", "MyCode0025", JustWarning, msg);
+    return;
+  }
+  G4cout << "---> Worker " << threadID << " pinned to CPU";
+  if ( cpus.size() > 1 ) G4cout << "s";
+  for ( auto cpu : cpus ) G4cout << " " << cpu;
+  if ( fPinning == kNumaPinning ) G4cout << " (NUMA node " << threadID % fNodes.size() << ")";
+  G4cout << G4endl;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......